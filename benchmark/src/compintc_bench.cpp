@@ -0,0 +1,372 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "compintc/hybrid_huffman.hpp"
+#include "distributions.hpp"
+
+using compc_bench::Distribution;
+
+namespace {
+
+constexpr uint64_t seed = 42;
+
+// The same input is used by all benchmarks of a (type, distribution, length)
+// combination, which are registered next to each other. Keeping only the last
+// array bounds the memory footprint of the huge inputs.
+template <typename T> const T* cached_input(Distribution distribution, std::size_t length) {
+  static std::unique_ptr<T[]> array = nullptr;
+  static Distribution cached_distribution = Distribution::uniform;
+  static std::size_t cached_length = 0;
+  if (array == nullptr || cached_distribution != distribution || cached_length != length) {
+    array = compc_bench::generate<T>(distribution, length, seed);
+    cached_distribution = distribution;
+    cached_length = length;
+  }
+  return array.get();
+}
+
+template <typename T>
+void set_counters(benchmark::State& state, std::size_t length, std::size_t compressed_bytes) {
+  int64_t processed = state.iterations() * static_cast<int64_t>(length);
+  state.SetItemsProcessed(processed);
+  state.SetBytesProcessed(processed * static_cast<int64_t>(sizeof(T)));
+  state.counters["bits_per_value"] =
+      static_cast<double>(compressed_bytes * 8) / static_cast<double>(std::max<std::size_t>(length, 1));
+}
+
+template <template <typename> class Codec, typename T>
+void bm_compress(benchmark::State& state, Distribution distribution, bool single_pass) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(distribution, length);
+  Codec<T> codec;
+  codec.num_threads = static_cast<int>(state.range(1));
+  codec.single_pass = single_pass;
+  std::size_t compressed_bytes = 0;
+  for (auto _ : state) {
+    std::size_t size = length;
+    std::unique_ptr<uint8_t[]> compressed = codec.compress(input, size);
+    benchmark::DoNotOptimize(compressed.get());
+    compressed_bytes = size;
+  }
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+template <template <typename> class Codec, typename T>
+void bm_decompress(benchmark::State& state, Distribution distribution, bool speculative) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(distribution, length);
+  Codec<T> codec;
+  codec.num_threads = static_cast<int>(state.range(1));
+  std::size_t compressed_bytes = length;
+  std::unique_ptr<uint8_t[]> compressed = codec.compress(input, compressed_bytes);
+  for (auto _ : state) {
+    std::unique_ptr<T[]> output = speculative
+                                      ? codec.decompress_speculative(compressed.get(), compressed_bytes, length)
+                                      : codec.decompress(compressed.get(), compressed_bytes, length);
+    benchmark::DoNotOptimize(output.get());
+  }
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+template <template <typename> class Codec, typename T> void bm_decompress_lanes(benchmark::State& state) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(Distribution::geometric, length);
+  Codec<T> codec;
+  std::size_t compressed_bytes = length;
+  std::unique_ptr<uint8_t[]> compressed =
+      codec.compress_lanes(input, compressed_bytes, static_cast<uint32_t>(state.range(1)));
+  for (auto _ : state) {
+    std::unique_ptr<T[]> output = codec.decompress_lanes(compressed.get(), compressed_bytes, length);
+    benchmark::DoNotOptimize(output.get());
+  }
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+template <template <typename> class Codec, typename T>
+void bm_bit_order(benchmark::State& state, compc::BitOrder bit_order, bool decompress) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(Distribution::geometric, length);
+  Codec<T> codec;
+  codec.num_threads = static_cast<int>(state.range(1));
+  codec.bit_order = bit_order;
+  std::size_t compressed_bytes = length;
+  std::unique_ptr<uint8_t[]> compressed = codec.compress(input, compressed_bytes);
+  for (auto _ : state) {
+    if (decompress) {
+      std::unique_ptr<T[]> output = codec.decompress(compressed.get(), compressed_bytes, length);
+      benchmark::DoNotOptimize(output.get());
+    } else {
+      std::size_t size = length;
+      std::unique_ptr<uint8_t[]> output = codec.compress(input, size);
+      benchmark::DoNotOptimize(output.get());
+    }
+  }
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+template <typename T> void bm_hybrid(benchmark::State& state, Distribution distribution, bool decompress) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(distribution, length);
+  compc::HybridHuffman<T> codec;
+  codec.num_threads = static_cast<int>(state.range(1));
+  std::size_t compressed_bytes = length;
+  std::unique_ptr<uint8_t[]> compressed = codec.compress(input, compressed_bytes);
+  for (auto _ : state) {
+    if (decompress) {
+      std::unique_ptr<T[]> output = codec.decompress(compressed.get(), compressed_bytes, length);
+      benchmark::DoNotOptimize(output.get());
+    } else {
+      std::size_t size = length;
+      std::unique_ptr<uint8_t[]> output = codec.compress(input, size);
+      benchmark::DoNotOptimize(output.get());
+    }
+  }
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+// latency of a compress and decompress round trip, on the small message path or on the parallel one
+template <template <typename> class Codec, typename T> void bm_round_trip(benchmark::State& state, bool small_path) {
+  auto length = static_cast<std::size_t>(state.range(0));
+  const T* input = cached_input<T>(Distribution::geometric, length);
+  Codec<T> codec;
+  codec.num_threads = static_cast<int>(state.range(1));
+  codec.small_message_threshold = small_path ? length + 1 : 0;
+  std::vector<double> latencies;
+  std::size_t compressed_bytes = 0;
+  for (auto _ : state) {
+    auto start = std::chrono::steady_clock::now();
+    std::size_t size = length;
+    std::unique_ptr<uint8_t[]> compressed = codec.compress(input, size);
+    std::unique_ptr<T[]> output = codec.decompress(compressed.get(), size, length);
+    benchmark::DoNotOptimize(output.get());
+    latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    compressed_bytes = size;
+  }
+  auto p99 = latencies.begin() + static_cast<std::ptrdiff_t>(latencies.size() * 99 / 100);
+  std::nth_element(latencies.begin(), p99, latencies.end());
+  state.counters["p99_us"] = *p99;
+  set_counters<T>(state, length, compressed_bytes);
+}
+
+// many small arrays, like the per-layer index arrays of a model
+constexpr std::size_t layers = 256;
+constexpr std::size_t layer_length = 1000;
+
+template <template <typename> class Codec, typename T> void bm_compress_layers(benchmark::State& state, bool batched) {
+  const T* input = cached_input<T>(Distribution::geometric, layers * layer_length);
+  std::vector<const T*> arrays;
+  for (std::size_t l = 0; l < layers; l++) {
+    arrays.push_back(input + l * layer_length);
+  }
+  const std::vector<std::size_t> lengths(layers, layer_length);
+  Codec<T> codec;
+  codec.num_threads = static_cast<int>(state.range(0));
+  std::size_t compressed_bytes = 0;
+  for (auto _ : state) {
+    if (batched) {
+      compc::CompressedBatch batch = codec.compress_batch(arrays, lengths);
+      benchmark::DoNotOptimize(batch.data.get());
+      compressed_bytes = batch.byte_offsets.back();
+    } else {
+      compressed_bytes = 0;
+      for (const T* array : arrays) {
+        std::size_t size = layer_length;
+        std::unique_ptr<uint8_t[]> compressed = codec.compress(array, size);
+        benchmark::DoNotOptimize(compressed.get());
+        compressed_bytes += size;
+      }
+    }
+  }
+  set_counters<T>(state, layers * layer_length, compressed_bytes);
+}
+
+std::vector<int64_t> thread_sweep() {
+  auto hardware_threads = static_cast<int64_t>(std::max(1U, std::thread::hardware_concurrency()));
+  std::vector<int64_t> threads;
+  for (int64_t t = 1; t < hardware_threads; t *= 2) {
+    threads.push_back(t);
+  }
+  threads.push_back(hardware_threads);
+  return threads;
+}
+
+template <template <typename> class Codec, typename T>
+void register_codec(const std::string& codec_name, const std::string& type_name) {
+  // small messages, arrays that fit into the caches, and arrays that do not
+  const std::vector<int64_t> lengths = {1 << 10, 1 << 16, 1 << 24};
+  const std::vector<int64_t> threads = thread_sweep();
+  for (int d = 0; d < compc_bench::number_of_distributions; d++) {
+    auto distribution = static_cast<Distribution>(d);
+    std::string suffix = codec_name + "/" + type_name + "/" + compc_bench::distribution_name(distribution);
+    for (int64_t length : lengths) {
+      for (int64_t t : threads) {
+        benchmark::RegisterBenchmark(("compress/" + suffix).c_str(), bm_compress<Codec, T>, distribution, false)
+            ->Args({length, t})
+            ->ArgNames({"n", "threads"})
+            ->UseRealTime()
+            ->Unit(benchmark::kMicrosecond);
+        benchmark::RegisterBenchmark(("decompress/" + suffix).c_str(), bm_decompress<Codec, T>, distribution, false)
+            ->Args({length, t})
+            ->ArgNames({"n", "threads"})
+            ->UseRealTime()
+            ->Unit(benchmark::kMicrosecond);
+      }
+    }
+  }
+}
+
+template <template <typename> class Codec> void register_types(const std::string& codec_name) {
+  register_codec<Codec, int16_t>(codec_name, "int16");
+  register_codec<Codec, uint16_t>(codec_name, "uint16");
+  register_codec<Codec, int32_t>(codec_name, "int32");
+  register_codec<Codec, uint32_t>(codec_name, "uint32");
+  register_codec<Codec, int64_t>(codec_name, "int64");
+  register_codec<Codec, uint64_t>(codec_name, "uint64");
+}
+
+void register_layers() {
+  for (int64_t t : thread_sweep()) {
+    benchmark::RegisterBenchmark("compress_layers/gamma/uint32/per_call",
+                                 bm_compress_layers<compc::EliasGamma, uint32_t>, false)
+        ->Arg(t)
+        ->ArgNames({"threads"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("compress_layers/gamma/uint32/batch",
+                                 bm_compress_layers<compc::EliasGamma, uint32_t>, true)
+        ->Arg(t)
+        ->ArgNames({"threads"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+  }
+}
+
+// the two pass and the single pass encoder on arrays that do not fit into the caches
+void register_single_pass() {
+  for (int64_t t : thread_sweep()) {
+    for (bool single_pass : {false, true}) {
+      std::string name = single_pass ? "compress_single_pass/" : "compress_two_pass/";
+      name += "gamma/uint32/geometric";
+      benchmark::RegisterBenchmark(name.c_str(), bm_compress<compc::EliasGamma, uint32_t>, Distribution::geometric,
+                                   single_pass)
+          ->Args({1 << 24, t})
+          ->ArgNames({"n", "threads"})
+          ->UseRealTime()
+          ->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+// messages around small_message_threshold, the threshold is where the parallel path starts to win
+void register_small_messages() {
+  for (int64_t t : thread_sweep()) {
+    for (bool small_path : {true, false}) {
+      std::string name = small_path ? "round_trip_small/" : "round_trip_parallel/";
+      name += "gamma/uint32/geometric";
+      benchmark::RegisterBenchmark(name.c_str(), bm_round_trip<compc::EliasGamma, uint32_t>, small_path)
+          ->ArgsProduct({{1 << 6, 1 << 8, 1 << 10, 1 << 12, 1 << 14, 1 << 16}, {t}})
+          ->ArgNames({"n", "threads"})
+          ->UseRealTime()
+          ->Unit(benchmark::kMicrosecond);
+    }
+  }
+}
+
+// the serial and the speculative parallel decoder of streams without a chunk index
+void register_speculative() {
+  for (int64_t t : thread_sweep()) {
+    benchmark::RegisterBenchmark("decompress_speculative/gamma/uint32/geometric",
+                                 bm_decompress<compc::EliasGamma, uint32_t>, Distribution::geometric, true)
+        ->Args({1 << 24, t})
+        ->ArgNames({"n", "threads"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+  }
+}
+
+// single threaded decoding of the interleaved layout, to compare with decompress/gamma/uint32/geometric/threads:1
+void register_lanes() {
+  for (int64_t lanes : {4, 8, 16}) {
+    benchmark::RegisterBenchmark("decompress_lanes/gamma/uint32/geometric",
+                                 bm_decompress_lanes<compc::EliasGamma, uint32_t>)
+        ->Args({1 << 24, lanes})
+        ->ArgNames({"n", "lanes"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("decompress_lanes/delta/uint32/geometric",
+                                 bm_decompress_lanes<compc::EliasDelta, uint32_t>)
+        ->Args({1 << 24, lanes})
+        ->ArgNames({"n", "lanes"})
+        ->UseRealTime()
+        ->Unit(benchmark::kMicrosecond);
+  }
+}
+
+// both directions of the two bit orders, the codes have the same length in both
+template <template <typename> class Codec> void register_bit_order(const std::string& codec_name) {
+  for (int64_t t : thread_sweep()) {
+    for (bool decompress : {false, true}) {
+      for (compc::BitOrder bit_order : {compc::BitOrder::msb_first, compc::BitOrder::lsb_first}) {
+        std::string name = decompress ? "decompress_" : "compress_";
+        name += bit_order == compc::BitOrder::lsb_first ? "lsb_first/" : "msb_first/";
+        name += codec_name + "/uint32/geometric";
+        benchmark::RegisterBenchmark(name.c_str(), bm_bit_order<Codec, uint32_t>, bit_order, decompress)
+            ->Args({1 << 24, t})
+            ->ArgNames({"n", "threads"})
+            ->UseRealTime()
+            ->Unit(benchmark::kMicrosecond);
+      }
+    }
+  }
+}
+
+void register_hybrid() {
+  for (int d = 0; d < compc_bench::number_of_distributions; d++) {
+    auto distribution = static_cast<Distribution>(d);
+    std::string suffix = std::string("hybrid/uint32/") + compc_bench::distribution_name(distribution);
+    for (int64_t t : thread_sweep()) {
+      for (bool decompress : {false, true}) {
+        benchmark::RegisterBenchmark(((decompress ? "decompress/" : "compress/") + suffix).c_str(),
+                                     bm_hybrid<uint32_t>, distribution, decompress)
+            ->Args({1 << 24, t})
+            ->ArgNames({"n", "threads"})
+            ->UseRealTime()
+            ->Unit(benchmark::kMicrosecond);
+      }
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  register_types<compc::EliasGamma>("gamma");
+  register_types<compc::EliasDelta>("delta");
+  register_types<compc::EliasOmega>("omega");
+  register_layers();
+  register_single_pass();
+  register_small_messages();
+  register_speculative();
+  register_lanes();
+  register_bit_order<compc::EliasGamma>("gamma");
+  register_bit_order<compc::EliasDelta>("delta");
+  register_bit_order<compc::EliasOmega>("omega");
+  register_hybrid();
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+    return 1;
+  }
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,134 @@
+#include "distributions.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr uint64_t universe_bits = 24;
+
+template <typename T> uint64_t max_value() {
+  return std::min(static_cast<uint64_t>(std::numeric_limits<T>::max()), uint64_t{1} << universe_bits);
+}
+
+template <typename T> T clamp_value(uint64_t value) {
+  return static_cast<T>(std::clamp(value, uint64_t{1}, max_value<T>()));
+}
+
+template <typename T> void fill_uniform(T* array, std::size_t length, std::mt19937_64& engine) {
+  std::uniform_int_distribution<uint64_t> dist(1, max_value<T>());
+  for (std::size_t i = 0; i < length; i++) {
+    array[i] = static_cast<T>(dist(engine));
+  }
+}
+
+template <typename T> void fill_geometric(T* array, std::size_t length, std::mt19937_64& engine) {
+  std::geometric_distribution<uint64_t> dist(0.05);
+  for (std::size_t i = 0; i < length; i++) {
+    array[i] = clamp_value<T>(dist(engine) + 1);
+  }
+}
+
+template <typename T> void fill_zipf(T* array, std::size_t length, std::mt19937_64& engine) {
+  // inverse transform sampling over a precomputed cdf
+  const std::size_t ranks = static_cast<std::size_t>(std::min(max_value<T>(), uint64_t{1} << 16U));
+  std::vector<double> cdf(ranks);
+  double sum = 0.0;
+  for (std::size_t r = 0; r < ranks; r++) {
+    sum += 1.0 / std::pow(static_cast<double>(r + 1), 1.2);
+    cdf[r] = sum;
+  }
+  std::uniform_real_distribution<double> dist(0.0, sum);
+  for (std::size_t i = 0; i < length; i++) {
+    auto it = std::lower_bound(cdf.begin(), cdf.end(), dist(engine));
+    array[i] = clamp_value<T>(static_cast<uint64_t>(it - cdf.begin()) + 1);
+  }
+}
+
+template <typename T> void fill_clustered(T* array, std::size_t length, std::mt19937_64& engine) {
+  constexpr std::size_t clusters = 32;
+  std::uniform_int_distribution<uint64_t> center_dist(1, max_value<T>());
+  std::vector<uint64_t> centers(clusters);
+  for (auto& center : centers) {
+    center = center_dist(engine);
+  }
+  std::uniform_int_distribution<std::size_t> pick(0, clusters - 1);
+  std::normal_distribution<double> spread(0.0, 64.0);
+  for (std::size_t i = 0; i < length; i++) {
+    auto delta = static_cast<int64_t>(spread(engine));
+    auto value = static_cast<int64_t>(centers[pick(engine)]) + delta;
+    array[i] = clamp_value<T>(static_cast<uint64_t>(std::max<int64_t>(value, 1)));
+  }
+}
+
+template <typename T> void fill_sorted_gaps(T* array, std::size_t length, std::mt19937_64& engine) {
+  // walks a universe where every 4096 positions toggle between a hot (p = 0.5)
+  // and a cold (p = 0.002) region and emits the gaps between selected indices
+  std::bernoulli_distribution hot(0.5);
+  std::bernoulli_distribution cold(0.002);
+  uint64_t position = 0;
+  uint64_t last = 0;
+  std::size_t i = 0;
+  while (i < length) {
+    position++;
+    bool selected = ((position >> 12U) & 1U) ? hot(engine) : cold(engine);
+    if (selected) {
+      array[i++] = clamp_value<T>(position - last);
+      last = position;
+    }
+  }
+}
+
+} // namespace
+
+const char* compc_bench::distribution_name(Distribution distribution) {
+  switch (distribution) {
+  case Distribution::uniform:
+    return "uniform";
+  case Distribution::geometric:
+    return "geometric";
+  case Distribution::zipf:
+    return "zipf";
+  case Distribution::clustered:
+    return "clustered";
+  case Distribution::sorted_gaps:
+    return "sorted_gaps";
+  }
+  return "unknown";
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc_bench::generate(Distribution distribution, std::size_t length, uint64_t seed) {
+  std::mt19937_64 engine(seed);
+  std::unique_ptr<T[]> array(new T[length]);
+  switch (distribution) {
+  case Distribution::uniform:
+    fill_uniform(array.get(), length, engine);
+    break;
+  case Distribution::geometric:
+    fill_geometric(array.get(), length, engine);
+    break;
+  case Distribution::zipf:
+    fill_zipf(array.get(), length, engine);
+    break;
+  case Distribution::clustered:
+    fill_clustered(array.get(), length, engine);
+    break;
+  case Distribution::sorted_gaps:
+    fill_sorted_gaps(array.get(), length, engine);
+    break;
+  }
+  return array;
+}
+
+template std::unique_ptr<int16_t[]> compc_bench::generate<int16_t>(Distribution, std::size_t, uint64_t);
+template std::unique_ptr<uint16_t[]> compc_bench::generate<uint16_t>(Distribution, std::size_t, uint64_t);
+template std::unique_ptr<int32_t[]> compc_bench::generate<int32_t>(Distribution, std::size_t, uint64_t);
+template std::unique_ptr<uint32_t[]> compc_bench::generate<uint32_t>(Distribution, std::size_t, uint64_t);
+template std::unique_ptr<int64_t[]> compc_bench::generate<int64_t>(Distribution, std::size_t, uint64_t);
+template std::unique_ptr<uint64_t[]> compc_bench::generate<uint64_t>(Distribution, std::size_t, uint64_t);
@@ -0,0 +1,30 @@
+#ifndef COMPC_BENCH_DISTRIBUTIONS_H_
+#define COMPC_BENCH_DISTRIBUTIONS_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+namespace compc_bench {
+
+/*
+  Input distributions the benchmarks are run on. All of them produce strictly
+  positive values that fit into the requested type, so they can be fed to the
+  codecs without an offset or a mapping of negative numbers.
+
+  uniform:     indices drawn uniformly from a 2^24 universe (capped by the type).
+  geometric:   small values with an exponentially decaying tail (p = 0.05).
+  zipf:        heavy tailed ranks, s = 1.2 over 2^16 ranks.
+  clustered:   indices concentrated around a few hot regions of the universe.
+  sorted_gaps: gaps of a sorted top-k style index set with hot and cold regions.
+*/
+enum class Distribution : int { uniform = 0, geometric = 1, zipf = 2, clustered = 3, sorted_gaps = 4 };
+
+constexpr int number_of_distributions = 5;
+
+const char* distribution_name(Distribution distribution);
+
+template <typename T> std::unique_ptr<T[]> generate(Distribution distribution, std::size_t length, uint64_t seed);
+
+} // namespace compc_bench
+
+#endif // COMPC_BENCH_DISTRIBUTIONS_H_
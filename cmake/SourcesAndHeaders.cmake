@@ -1,11 +1,33 @@
-set(sources src/elias_gamma.cpp src/elias_delta.cpp src/elias_omega.cpp)
+set(sources src/elias_base.cpp src/elias_gamma.cpp src/elias_delta.cpp
+            src/elias_omega.cpp src/container.cpp src/crc32c.cpp
+            src/sparse.cpp src/index_set.cpp src/index_stream.cpp
+            src/async.cpp src/selection.cpp src/hybrid_huffman.cpp
+            src/session.cpp src/thread_budget.cpp src/buffer_cache.cpp)
 
 set(exe_sources src/main.cpp ${sources})
 
 set(headers
     include/compintc/compressor.hpp include/compintc/elias_base.hpp
     include/compintc/elias_gamma.hpp include/compintc/elias_delta.hpp
-    include/compintc/elias_omega.hpp include/compintc/helpers.hpp)
+    include/compintc/elias_omega.hpp include/compintc/helpers.hpp
+    include/compintc/stats.hpp include/compintc/container.hpp
+    include/compintc/elias_factory.hpp include/compintc/crc32c.hpp
+    include/compintc/sparse.hpp include/compintc/index_set.hpp
+    include/compintc/index_stream.hpp include/compintc/async.hpp
+    include/compintc/selection.hpp include/compintc/decode_apply.hpp
+    include/compintc/hybrid_huffman.hpp include/compintc/session.hpp
+    include/compintc/thread_budget.hpp include/compintc/buffer_cache.hpp)
 
 set(test_sources src/elias_gamma_test.cpp src/elias_delta_test.cpp
-                 src/elias_omega_test.cpp)
+                 src/elias_omega_test.cpp src/container_test.cpp
+                 src/crc32c_test.cpp src/batch_test.cpp
+                 src/sparse_test.cpp src/index_set_test.cpp
+                 src/index_stream_test.cpp src/async_test.cpp
+                 src/segments_test.cpp src/selection_test.cpp
+                 src/decode_apply_test.cpp src/single_pass_test.cpp
+                 src/speculative_test.cpp src/hybrid_huffman_test.cpp
+                 src/session_test.cpp src/lanes_test.cpp src/small_message_test.cpp
+                 src/thread_budget_test.cpp src/bit_order_test.cpp
+                 src/buffer_cache_test.cpp)
+
+set(bench_sources src/compintc_bench.cpp src/distributions.cpp)
@@ -44,6 +44,14 @@ option(${PROJECT_NAME}_USE_GOOGLE_MOCK
 option(${PROJECT_NAME}_USE_CATCH2
        "Use the Catch2 project for creating unit tests." OFF)
 
+#
+# Benchmarks
+#
+# Currently supporting: Google Benchmark.
+
+option(${PROJECT_NAME}_ENABLE_BENCHMARKING
+       "Build the Google Benchmark suite (from the `benchmark` subfolder)." OFF)
+
 #
 # Static analyzers
 #
@@ -0,0 +1,162 @@
+#ifndef COMPC_ASYNC_H_
+#define COMPC_ASYNC_H_
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "compintc/thread_budget.hpp"
+namespace compc {
+
+// output of an asynchronous compress
+struct CompressedBuffer {
+  std::unique_ptr<uint8_t[]> data{};
+  std::size_t size = 0;
+};
+
+class AsyncExecutor {
+  /*
+    Runs compress and decompress calls on a fixed set of worker threads, so
+    the caller can overlap them with other work, e.g. sending the previous
+    layer. At most max_in_flight operations run at the same time. Every one of
+    them leases capacity / max_in_flight threads from the ThreadBudget of the
+    executor for its OpenMP teams, so the operations in flight never use more
+    threads than the budget holds. With a budget shared with other callers of
+    the compressors, the executor and the callers are bounded together, and
+    an operation that finds the budget used up runs on its worker thread only.
+
+    The codec is copied when the operation is submitted, the input array has
+    to stay valid until the operation completed. The copy does not record stats.
+    Exceptions of compress and decompress reach the future or turn into a
+    nullptr for the callback, the workers keep running. An exception thrown
+    by a callback itself is dropped.
+  */
+public:
+  // uses a budget of its own with the given number of threads, 0 uses all hardware threads
+  explicit AsyncExecutor(int threads = 0, int max_in_flight = 2);
+  // leases from a budget shared with other users, the budget has to outlive the executor
+  explicit AsyncExecutor(ThreadBudget& budget, int max_in_flight = 2);
+  AsyncExecutor(const AsyncExecutor&) = delete;
+  AsyncExecutor& operator=(const AsyncExecutor&) = delete;
+  // completes all submitted operations
+  ~AsyncExecutor();
+
+  ThreadBudget& budget() const { return *shared_budget; }
+  // threads an operation asks the budget for
+  int threads_per_operation() const { return operation_threads; }
+
+  // the future rethrows an exception of compress, e.g. std::bad_alloc
+  template <typename Codec, typename T>
+  std::future<CompressedBuffer> compress_async(Codec codec, const T* array, std::size_t size) {
+    auto promise = std::make_shared<std::promise<CompressedBuffer>>();
+    std::future<CompressedBuffer> future = promise->get_future();
+    auto owned = std::make_shared<Codec>(std::move(codec));
+    submit([owned, array, size, promise](int threads) {
+      CompressedBuffer buffer;
+      try {
+        buffer = run_compress(*owned, array, size, threads);
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+        return;
+      }
+      promise->set_value(std::move(buffer));
+    });
+    return future;
+  }
+
+  /*
+    The callback runs on the worker thread, the data is a nullptr for invalid inputs like with compress(), and if
+    compress threw, e.g. std::bad_alloc.
+  */
+  template <typename Codec, typename T>
+  void compress_async(Codec codec, const T* array, std::size_t size, std::function<void(CompressedBuffer)> callback) {
+    auto owned = std::make_shared<Codec>(std::move(codec));
+    submit([owned, array, size, callback = std::move(callback)](int threads) {
+      CompressedBuffer buffer;
+      try {
+        buffer = run_compress(*owned, array, size, threads);
+      } catch (...) {
+        buffer = CompressedBuffer{};
+      }
+      callback(std::move(buffer));
+    });
+  }
+
+  // the future rethrows an exception of decompress, e.g. std::bad_alloc
+  template <typename Codec, typename T>
+  std::future<std::unique_ptr<T[]>> decompress_async(Codec codec, const uint8_t* array, std::size_t binary_length,
+                                                     std::size_t array_length) {
+    auto promise = std::make_shared<std::promise<std::unique_ptr<T[]>>>();
+    std::future<std::unique_ptr<T[]>> future = promise->get_future();
+    auto owned = std::make_shared<Codec>(std::move(codec));
+    submit([owned, array, binary_length, array_length, promise](int threads) {
+      std::unique_ptr<T[]> output = nullptr;
+      try {
+        owned->num_threads = threads;
+        output = owned->decompress(array, binary_length, array_length);
+      } catch (...) {
+        promise->set_exception(std::current_exception());
+        return;
+      }
+      promise->set_value(std::move(output));
+    });
+    return future;
+  }
+
+  // the callback receives a nullptr if decompress threw, e.g. std::bad_alloc
+  template <typename Codec, typename T>
+  void decompress_async(Codec codec, const uint8_t* array, std::size_t binary_length, std::size_t array_length,
+                        std::function<void(std::unique_ptr<T[]>)> callback) {
+    auto owned = std::make_shared<Codec>(std::move(codec));
+    submit([owned, array, binary_length, array_length, callback = std::move(callback)](int threads) {
+      std::unique_ptr<T[]> output = nullptr;
+      try {
+        owned->num_threads = threads;
+        output = owned->decompress(array, binary_length, array_length);
+      } catch (...) {
+        output = nullptr;
+      }
+      callback(std::move(output));
+    });
+  }
+
+  // blocks until all operations submitted so far completed
+  void wait_idle();
+
+private:
+  template <typename Codec, typename T>
+  static CompressedBuffer run_compress(Codec& codec, const T* array, std::size_t size, int threads) {
+    codec.num_threads = threads;
+    CompressedBuffer buffer;
+    buffer.size = size;
+    buffer.data = codec.compress(array, buffer.size);
+    return buffer;
+  }
+
+  void start(int max_in_flight);
+  void submit(std::function<void(int)> task);
+  void work();
+
+  std::unique_ptr<ThreadBudget> own_budget{};
+  ThreadBudget* shared_budget{nullptr};
+  int operation_threads{1};
+  std::vector<std::thread> workers{};
+  std::deque<std::function<void(int)>> tasks{};
+  std::mutex mutex{};
+  std::condition_variable task_available{};
+  std::condition_variable idle{};
+  std::size_t running{0};
+  bool stopping{false};
+};
+
+} // namespace compc
+
+#endif // COMPC_ASYNC_H_
@@ -0,0 +1,98 @@
+#ifndef COMPC_BUFFER_CACHE_H_
+#define COMPC_BUFFER_CACHE_H_
+#include <cstdint>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "compintc/elias_base.hpp"
+namespace compc {
+
+// output of compress for an array of values numbers, shared read-only by everyone holding a handle
+struct CompressedBytes {
+  std::unique_ptr<uint8_t[]> data{};
+  std::size_t size = 0;
+  std::size_t values = 0;
+};
+
+// stays valid after the entry is evicted, as long as the handle is held
+using CachedBuffer = std::shared_ptr<const CompressedBytes>;
+
+struct BufferCacheStats {
+  std::size_t hits = 0;
+  std::size_t misses = 0;
+  std::size_t evictions = 0;
+  std::size_t entries = 0;
+  std::size_t bytes = 0; // compressed bytes held by the cache
+};
+
+class BufferCache {
+  /*
+    Compress once, send to many: remembers the output of compress for arrays
+    that are sent again, e.g. the same index array to several neighbours.
+    Entries are keyed by a 128 bit hash of the input bytes together with the
+    codec, the type, the offset, map_negative_numbers and the bit order, so
+    compressors with a different configuration never share an entry. The
+    hash is fast, not cryptographic; inputs chosen to collide could be
+    served each other's bytes.
+
+    The cache holds at most capacity_bytes compressed bytes and evicts the
+    least recently used entries first. An output larger than the capacity is
+    returned but not cached. All members can be called concurrently. The
+    input is hashed and compressed outside of the lock, two threads missing
+    the same key at once both compress, and the first one's output is kept.
+  */
+public:
+  explicit BufferCache(std::size_t capacity_bytes);
+  BufferCache(const BufferCache&) = delete;
+  BufferCache& operator=(const BufferCache&) = delete;
+
+  /*
+    Returns the cached output of codec.compress(array, size) or compresses and caches it.
+    Returns a nullptr, without caching anything, if the array contains a number that cannot be encoded.
+  */
+  template <typename T> CachedBuffer compress(EliasBase<T>& codec, const T* array, std::size_t size);
+
+  std::size_t capacity() const { return capacity_bytes; }
+  BufferCacheStats stats() const;
+  // drops all entries, handles that are held stay valid, the counters are kept
+  void clear();
+
+private:
+  struct Key {
+    uint64_t hash_low;
+    uint64_t hash_high;
+    std::size_t values;
+    int64_t offset;
+    uint8_t codec;
+    uint8_t type_width;
+    bool type_signed;
+    bool map_negative_numbers;
+    uint8_t bit_order;
+
+    bool operator==(const Key& other) const;
+  };
+  struct KeyHash {
+    std::size_t operator()(const Key& key) const { return static_cast<std::size_t>(key.hash_low); }
+  };
+  struct Entry {
+    Key key;
+    CachedBuffer buffer;
+  };
+
+  CachedBuffer find(const Key& key);
+  CachedBuffer insert(const Key& key, CachedBuffer buffer);
+
+  std::size_t capacity_bytes;
+  mutable std::mutex mutex{};
+  // most recently used first
+  std::list<Entry> entries{};
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index{};
+  BufferCacheStats counters{};
+};
+
+} // namespace compc
+
+#endif // COMPC_BUFFER_CACHE_H_
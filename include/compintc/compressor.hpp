@@ -3,39 +3,58 @@
 #include <cstdlib>
 #include <omp.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+
+#include "compintc/stats.hpp"
+#include "compintc/thread_budget.hpp"
 namespace compc {
 
+// OMP_NUM_THREADS if it is set, otherwise 1, the num_threads of default constructed compressors
+inline int default_num_threads() {
+  char* num_threads_char = std::getenv("OMP_NUM_THREADS");
+  if (num_threads_char == nullptr) {
+    return 1;
+  }
+  return std::max(static_cast<int>(std::strtol(num_threads_char, nullptr, 10)), 1);
+}
+
 template <typename T> class Compressor {
+  /*
+    Thread safety: compress, decompress and the other calls of the codecs only read the members, so one compressor
+    can be used by several threads at once, as long as its members are not changed meanwhile and stats is a nullptr.
+    The calls of concurrent users share the final prefix hooks of the Elias codecs.
+
+    Every call opens its own OpenMP teams of num_threads threads. Compressors that are called concurrently should
+    share a ThreadBudget, which bounds the threads of all calls in flight together. The constructors do not change
+    the OpenMP defaults of the process.
+  */
 public:
   int num_threads{1};
-  Compressor() {
-    char* num_threads_char = std::getenv("OMP_NUM_THREADS");
-    if (num_threads_char != nullptr) {
-      int omp_threads = static_cast<int>(std::strtol(num_threads_char, nullptr, 10));
-      this->num_threads = std::max(omp_threads, 1);
-    } else {
-      this->num_threads = 1;
-    }
-    omp_set_num_threads(this->num_threads);
-  };
-  explicit Compressor(int number_of_threads) : num_threads(number_of_threads) {
-    omp_set_num_threads(this->num_threads);
-  };
+  // if set, compress and decompress record their performance counters here
+  CompressionStats* stats{nullptr};
+  // if set, the threads of every call are leased from this budget, see ThreadBudget
+  ThreadBudget* thread_budget{nullptr};
+  Compressor() : num_threads(default_num_threads()){};
+  explicit Compressor(int number_of_threads) : num_threads(number_of_threads){};
   virtual ~Compressor() = default;
   virtual std::unique_ptr<uint8_t[]> compress(const T*, std::size_t&) = 0;
   virtual std::unique_ptr<T[]> decompress(const uint8_t*, std::size_t, std::size_t) = 0;
   virtual std::size_t get_compressed_length(const T*, std::size_t) = 0;
   // copy cunstructor
-  Compressor(Compressor& other) : Compressor(other.num_threads){};
+  Compressor(Compressor& other) : Compressor(other.num_threads) { this->thread_budget = other.thread_budget; };
   // move cunstructor
   Compressor(Compressor&& other) noexcept // move constructor
-      : num_threads(std::exchange(other.num_threads, 0)){};
+      : num_threads(std::exchange(other.num_threads, 0)),
+        thread_budget(std::exchange(other.thread_budget, nullptr)){};
   // copy operator
   Compressor& operator=(const Compressor& other) = default;
   Compressor& operator=(Compressor&& other) noexcept = default;
 
+  // threads for the parallel regions of the current call, num_threads limited by the lease of the call
+  int threads() const { return ThreadLease::limit(this->num_threads); }
+
   void transform_to_natural_numbers(T* array, const std::size_t& size)
   /*
     array: array of numbers to transform
@@ -47,7 +66,7 @@ public:
 
   */
   {
-    int local_threads = this->num_threads;
+    int local_threads = this->threads();
     if (size < static_cast<std::size_t>(local_threads)) {
       local_threads = 1;
     }
@@ -72,7 +91,7 @@ public:
 
   */
   {
-    int local_threads = this->num_threads;
+    int local_threads = this->threads();
     if (size < static_cast<std::size_t>(local_threads)) {
       local_threads = 1;
     }
@@ -87,7 +106,7 @@ public:
   }
 
   void add_offset(T* array, const std::size_t& size, T offset) {
-    int local_threads = this->num_threads;
+    int local_threads = this->threads();
     if (size < static_cast<std::size_t>(local_threads)) {
       local_threads = 1;
     }
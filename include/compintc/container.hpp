@@ -0,0 +1,101 @@
+#ifndef COMPC_CONTAINER_H_
+#define COMPC_CONTAINER_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/thread_budget.hpp"
+namespace compc {
+
+/*
+  Self-describing frame around a compressed array. All fields are little endian.
+
+  byte  0: magic "CIC"
+  byte  3: version
+  byte  4: codec id (see CodecId)
+  byte  5: type, width in bytes | 0x80 if signed
+  byte  6: flags, bit 0: map_negative_numbers, bit 1: chunk index present, bit 2: checksums present,
+           bit 3: the payload is BitOrder::lsb_first
+  byte  7: reserved, 0
+  byte  8: number of values (uint64)
+  byte 16: offset (int64)
+  byte 24: payload size in bytes (uint64)
+  byte 32: values per chunk of the chunk index (uint32)
+  byte 36: number of chunks in the chunk index (uint32)
+  byte 40: chunk index, the length of every chunk in bits (uint32 each)
+  with checksums: the crc32c_bits checksum of every chunk (uint32 each),
+                  followed by the crc32c of all preceding header bytes (uint32)
+  followed by the payload, the output of compress().
+
+  The chunk index allows decompress_auto to decode the chunks in parallel.
+  Checksums require a chunk index. They are computed inside the parallel
+  encode loop and verified per chunk while decoding.
+*/
+constexpr uint8_t frame_version = 1;
+constexpr std::size_t frame_header_size = 40;
+
+struct FrameHeader {
+  uint8_t version = frame_version;
+  CodecId codec = CodecId::gamma;
+  uint8_t type_width = 0;
+  bool type_signed = false;
+  bool map_negative_numbers = false;
+  bool has_chunk_index = false;
+  bool has_checksums = false;
+  BitOrder bit_order = BitOrder::msb_first;
+  uint64_t count = 0;
+  int64_t offset = 0;
+  uint64_t payload_bytes = 0;
+  uint32_t batch_size = 0;
+  uint32_t chunk_count = 0;
+
+  // size of the header including the chunk index, i.e., where the payload starts
+  std::size_t header_bytes() const;
+};
+
+// parses and validates the header, returns false if the frame is malformed or truncated
+bool read_frame_header(const uint8_t* frame, std::size_t frame_length, FrameHeader& header);
+void write_frame_header(uint8_t* frame, const FrameHeader& header);
+// the chunk index of a frame turned into chunk end bits, false if they exceed the payload
+bool read_chunk_end_bits(const uint8_t* frame, const FrameHeader& header, std::vector<std::size_t>& end_bits);
+
+/*
+  codec: compressor whose codec, offset, mapping and bit order are recorded in the header
+  array: array to be compressed
+  size: size of the array, gets overwritten by the size of the frame
+  chunk_index: whether to store the bit length of every chunk for parallel decoding
+  checksums: whether to store a CRC32C checksum of every chunk, only used together with a chunk index
+
+  Returns a nullptr for invalid inputs, like compress().
+*/
+template <typename T>
+std::unique_ptr<uint8_t[]> compress_framed(EliasBase<T>& codec, const T* array, std::size_t& size,
+                                           bool chunk_index = true, bool checksums = false);
+
+/*
+  frame: output of compress_framed
+  frame_length: size of the frame in bytes
+  array_length: gets overwritten by the number of decoded values
+  num_threads: threads used to decode a frame with a chunk index, 0 uses the default of the compressors
+  corrupt_chunks: if set, receives the indices of the chunks whose checksum does not match
+  thread_budget: if set, the threads are leased from it, see ThreadBudget
+
+  Returns a nullptr if the frame is malformed, corrupt or was not written for the type T.
+*/
+template <typename T>
+std::unique_ptr<T[]> decompress_auto(const uint8_t* frame, std::size_t frame_length, std::size_t& array_length,
+                                     int num_threads = 0, std::vector<std::size_t>* corrupt_chunks = nullptr,
+                                     ThreadBudget* thread_budget = nullptr);
+
+/*
+  Verifies the checksums of a frame without decoding it, frames without checksums only have their header checked.
+  num_threads and thread_budget work like for decompress_auto.
+*/
+bool verify_frame(const uint8_t* frame, std::size_t frame_length, std::vector<std::size_t>* corrupt_chunks = nullptr,
+                  int num_threads = 0, ThreadBudget* thread_budget = nullptr);
+
+} // namespace compc
+
+#endif // COMPC_CONTAINER_H_
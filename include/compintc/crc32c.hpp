@@ -0,0 +1,29 @@
+#ifndef COMPC_CRC32C_H_
+#define COMPC_CRC32C_H_
+#include <cstdint>
+#include <cstdlib>
+
+namespace compc {
+
+/*
+  CRC32C (Castagnoli) checksums. crc32c uses the SSE4.2 crc32 instruction if
+  the CPU supports it and falls back to a portable slicing-by-8 implementation
+  otherwise. Both continue from crc, which is 0 for a new checksum.
+*/
+uint32_t crc32c(const uint8_t* data, std::size_t length, uint32_t crc = 0);
+uint32_t crc32c_portable(const uint8_t* data, std::size_t length, uint32_t crc = 0);
+bool crc32c_hardware_accelerated();
+
+/*
+  Checksum of the bits [start_bit, end_bit) of data. Bits of the first and last
+  byte outside of the range are masked out, so chunks sharing a boundary byte
+  get independent checksums. The two boundary bytes are read atomically, this
+  allows computing the checksum while neighbouring chunks are still written.
+  lsb_first selects the bit order of BitOrder::lsb_first streams, where bit k
+  is bit k % 8 of byte k / 8.
+*/
+uint32_t crc32c_bits(const uint8_t* data, std::size_t start_bit, std::size_t end_bit, bool lsb_first = false);
+
+} // namespace compc
+
+#endif // COMPC_CRC32C_H_
@@ -0,0 +1,148 @@
+#ifndef COMPC_DECODE_APPLY_H_
+#define COMPC_DECODE_APPLY_H_
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "compintc/container.hpp"
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+namespace compc {
+
+// number of values decoded into a stack buffer before they are handed to the sink
+constexpr std::size_t apply_block_size = 256;
+
+/*
+  Decodes a frame and calls sink(position, value) for every value as soon as
+  its block is decoded, without allocating the output array. With a chunk
+  index, the chunks are decoded in parallel and the sink is called from
+  several threads at once, for different positions. Frames with checksums are
+  verified before the sink is called for the first time.
+
+  Returns false if the frame is malformed, corrupt or was not written for the
+  type T. A chunk whose end does not match the index is only detected after
+  its values were passed to the sink. If thread_budget is set, the threads of
+  the checksum check and the decode are leased from it.
+*/
+template <typename T, typename Sink>
+bool decode_apply(const uint8_t* frame, std::size_t frame_length, Sink&& sink, int num_threads = 0,
+                  ThreadBudget* thread_budget = nullptr) {
+  FrameHeader header;
+  if (!read_frame_header(frame, frame_length, header) || header.type_width != sizeof(T) ||
+      header.type_signed != std::is_signed_v<T>) {
+    return false;
+  }
+  std::unique_ptr<EliasBase<T>> codec = make_elias<T>(header.codec);
+  codec->bit_order = header.bit_order;
+  codec->thread_budget = thread_budget;
+  if (num_threads > 0) {
+    codec->num_threads = num_threads;
+  }
+  ThreadLease lease(codec->thread_budget, codec->num_threads);
+  if (header.has_checksums && !verify_frame(frame, frame_length, nullptr, codec->threads())) {
+    return false;
+  }
+  const uint8_t* payload = frame + header.header_bytes();
+  const std::size_t payload_bytes = header.payload_bytes;
+  const std::size_t count = header.count;
+  std::vector<std::size_t> chunk_end_bits;
+  std::size_t batch_size = std::max<std::size_t>(count, 1);
+  std::size_t chunks = count == 0 ? 0 : 1;
+  if (header.has_chunk_index) {
+    if (!read_chunk_end_bits(frame, header, chunk_end_bits)) {
+      return false;
+    }
+    batch_size = header.batch_size;
+    chunks = header.chunk_count;
+  }
+  int local_threads = codec->threads();
+  if (chunks < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(chunks), 1);
+  }
+  const auto offset = static_cast<T>(header.offset);
+  const bool map_negative_numbers = header.map_negative_numbers;
+  EliasBase<T>& kernels = *codec;
+  bool error = false;
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(kernels, payload, chunk_end_bits, sink)             \
+    reduction(|| : error) firstprivate(chunks, batch_size, count, payload_bytes, offset, map_negative_numbers)       \
+    num_threads(local_threads)
+  for (std::size_t c = 0; c < chunks; c++) {
+    T block[apply_block_size];
+    std::size_t bit = c == 0 ? 0 : chunk_end_bits[c - 1];
+    std::size_t end = std::min((c + 1) * batch_size, count);
+    for (std::size_t position = c * batch_size; position < end; position += apply_block_size) {
+      std::size_t n = end - position < apply_block_size ? end - position : apply_block_size;
+      bit = kernels.decode_chunk(payload, payload_bytes, bit, block, n);
+      for (std::size_t i = 0; i < n; i++) {
+        sink(position + i, revert_transforms(block[i], offset, map_negative_numbers));
+      }
+    }
+    error = error || bit > payload_bytes * 8 || (!chunk_end_bits.empty() && bit != chunk_end_bits[c]);
+  }
+  return !error;
+}
+
+template <typename T> bool index_in_range(T index, std::size_t length) {
+  if constexpr (std::is_signed_v<T>) {
+    if (index < 0) {
+      return false;
+    }
+  }
+  return static_cast<std::size_t>(index) < length;
+}
+
+/*
+  dense[index[i]] += values[i] for the indices in the frame, the additions are
+  atomic since an index can occur in several chunks. Returns false if the frame
+  is invalid or an index is out of range, such indices are skipped.
+*/
+template <typename T, typename V>
+bool scatter_add(const uint8_t* frame, std::size_t frame_length, const V* values, V* dense, std::size_t dense_length,
+                 int num_threads = 0, ThreadBudget* thread_budget = nullptr) {
+  std::atomic<bool> in_range{true};
+  bool valid = decode_apply<T>(
+      frame, frame_length,
+      [&](std::size_t position, T index) {
+        if (!index_in_range(index, dense_length)) {
+          in_range.store(false, std::memory_order_relaxed);
+          return;
+        }
+        V& target = dense[static_cast<std::size_t>(index)];
+#pragma omp atomic
+        target += values[position];
+      },
+      num_threads, thread_budget);
+  return valid && in_range.load();
+}
+
+// sets the bits of the indices in the frame in a bitset of 64 bit words, the same as scatter_add otherwise
+template <typename T>
+bool set_bits(const uint8_t* frame, std::size_t frame_length, uint64_t* bitset, std::size_t bits,
+              int num_threads = 0, ThreadBudget* thread_budget = nullptr) {
+  std::atomic<bool> in_range{true};
+  bool valid = decode_apply<T>(
+      frame, frame_length,
+      [&](std::size_t, T index) {
+        if (!index_in_range(index, bits)) {
+          in_range.store(false, std::memory_order_relaxed);
+          return;
+        }
+        auto bit = static_cast<std::size_t>(index);
+        uint64_t& word = bitset[bit / 64];
+        uint64_t mask = uint64_t{1} << (bit % 64);
+#pragma omp atomic
+        word |= mask;
+      },
+      num_threads, thread_budget);
+  return valid && in_range.load();
+}
+
+} // namespace compc
+
+#endif // COMPC_DECODE_APPLY_H_
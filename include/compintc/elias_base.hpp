@@ -1,8 +1,10 @@
 #ifndef COMPC_ELIAS_BASE_H_
 #define COMPC_ELIAS_BASE_H_
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstring>
+#include <functional>
 #include <iostream>
 #include <memory>
 #include <tuple>
@@ -13,6 +15,16 @@
 #include "compintc/helpers.hpp"
 namespace compc {
 
+// reverts the offset and the mapping of a single value, like transform_array_outputs
+template <typename T> T revert_transforms(T value, T offset, bool map_negative_numbers) {
+  T at_i = static_cast<T>(value - offset);
+  if (map_negative_numbers) {
+    T bi = static_cast<T>(at_i % 2);
+    at_i = static_cast<T>((at_i + 1) / static_cast<T>((2 - 4 * bi)));
+  }
+  return at_i;
+}
+
 struct ArrayPrefixSummary {
   int local_threads = 0;
   uint32_t batch_size = 0;
@@ -21,28 +33,177 @@ struct ArrayPrefixSummary {
   bool error = false;
 };
 
+// optional work done by encode_chunks while the bytes of a chunk are still in cache
+struct EncodeHooks {
+  // if set, receives the crc32c_bits checksum of every chunk
+  uint32_t* chunk_checksums = nullptr;
+  /*
+    Progress of the encode loop: whenever the chunks finished so far form a longer
+    contiguous prefix, the number of bytes of the output that are final is stored
+    in final_prefix_bytes and passed to on_final_prefix. The byte shared with the
+    next unfinished chunk is not final. The callback is called by one thread at a
+    time and in increasing order, it should return quickly. While either is set the
+    threads take the chunks one at a time in order instead of in ranges, so the
+    prefix grows steadily.
+  */
+  std::function<void(const uint8_t*, std::size_t)> on_final_prefix{};
+  std::atomic<std::size_t>* final_prefix_bytes = nullptr;
+};
+
+// several arrays compressed into one buffer, array i occupies the bytes [byte_offsets[i], byte_offsets[i + 1])
+struct CompressedBatch {
+  std::unique_ptr<uint8_t[]> data{};
+  std::vector<std::size_t> byte_offsets{};
+  std::vector<std::size_t> lengths{};
+};
+
+// part of a segmented output, like an iovec with the number of values it encodes
+struct Segment {
+  const uint8_t* data = nullptr;
+  std::size_t size = 0;
+  std::size_t values = 0;
+};
+
+// the segments of a compressed array, each starts at its own cache line of storage
+struct SegmentedOutput {
+  std::unique_ptr<uint8_t[]> storage{};
+  std::vector<Segment> segments{};
+};
+
+// identifies the codec in serialized formats, the values must never change
+enum class CodecId : uint8_t { gamma = 1, delta = 2, omega = 3 };
+
+/*
+  Order of the bits of a compressed stream, both orders have the same length.
+  msb_first: the bits of every byte are filled from the most significant one down, and the binary part of a code
+    starts with its most significant bit.
+  lsb_first: bit k of the stream is bit k % 8 of byte k / 8, and the binary part of a code starts with its least
+    significant bit. The decoder loads 8 bytes as a little endian word and finds the end of a prefix with a single
+    trailing zero count.
+*/
+enum class BitOrder : uint8_t { msb_first = 0, lsb_first = 1 };
+
 template <typename T> class EliasBase : public Compressor<T> {
 public:
   T offset{0};
   bool map_negative_numbers{false};
+  uint32_t batch_size_small{50};
+  uint32_t batch_size_large{1000};
+  // if set, compress reports the final prefix of its output while encoding, see EncodeHooks
+  std::function<void(const uint8_t*, std::size_t)> on_final_prefix{};
+  std::atomic<std::size_t>* final_prefix_bytes{nullptr};
+  // if set, compress uses encode_single_pass and does not report the final prefix
+  bool single_pass{false};
+  // arrays with fewer values take the single threaded small message path, see compress_small
+  std::size_t small_message_threshold{4096};
+  // layout of the compressed stream, decompress has to use the one compress used, see BitOrder
+  BitOrder bit_order{BitOrder::msb_first};
   EliasBase() = default;
   explicit EliasBase(T zero_offset) : offset(zero_offset){};
   EliasBase(T zero_offset, bool map_negative_numbers_to_positive)
       : offset(zero_offset), map_negative_numbers(map_negative_numbers_to_positive){};
+  EliasBase(T zero_offset, bool map_negative_numbers_to_positive, uint32_t batch_size_small_p,
+            uint32_t batch_size_large_p)
+      : offset(zero_offset), map_negative_numbers(map_negative_numbers_to_positive),
+        batch_size_small(batch_size_small_p), batch_size_large(batch_size_large_p){};
   virtual ~EliasBase() = default;
-  virtual ArrayPrefixSummary get_prefix_sum_array(const T*, std::size_t) = 0;
+  std::unique_ptr<uint8_t[]> compress(const T*, std::size_t&) override;
+  std::unique_ptr<T[]> decompress(const uint8_t*, std::size_t, std::size_t) override;
+  std::size_t get_compressed_length(const T*, std::size_t) override;
+  virtual ArrayPrefixSummary get_prefix_sum_array(const T*, std::size_t);
+  // encodes all chunks of the summary in parallel into the zero initialized compressed array
+  void encode_chunks(const T*, std::size_t, const ArrayPrefixSummary&, uint8_t*, const EncodeHooks& = {});
+  /*
+    Encodes without a separate sizing pass over the whole array. Every thread sizes and encodes its contiguous range
+    of chunks one after another into a scratch buffer, so the second read of a chunk hits the cache. The scratch
+    buffers are then shifted into place in parallel, the output is bit identical to the one of compress. Sets the
+    compressed length in bytes, returns a nullptr if the array contains a number that cannot be encoded.
+  */
+  std::unique_ptr<uint8_t[]> encode_single_pass(const T*, std::size_t, std::size_t&);
+  /*
+    Decodes the chunks ending at the given bit offsets in parallel, every chunk but the last has batch_size values.
+    If checksums are given, every chunk is verified before it is decoded. The indices of corrupt chunks are
+    appended to corrupt_chunks in ascending order, and false is returned if there are any.
+  */
+  bool decode_chunks(const uint8_t*, std::size_t, const std::vector<std::size_t>&, uint32_t, T*, std::size_t,
+                     const uint32_t* = nullptr, std::vector<std::size_t>* = nullptr);
+  /*
+    Compresses many arrays with a single parallel region per phase. The chunks of all arrays are scheduled together,
+    so small arrays do not pay for forking a team each. Every array starts at a byte boundary of the shared buffer.
+    Returns a batch with a nullptr as data if an array contains a number that cannot be encoded.
+  */
+  CompressedBatch compress_batch(const std::vector<const T*>&, const std::vector<std::size_t>&);
+  // decodes the arrays in parallel, the values of all arrays are returned concatenated in order
+  std::unique_ptr<T[]> decompress_batch(const uint8_t*, const std::vector<std::size_t>&,
+                                        const std::vector<std::size_t>&);
+  std::unique_ptr<T[]> decompress_batch(const CompressedBatch&);
+  /*
+    Compresses into separate byte aligned segments of chunks_per_segment chunks each. Every segment is encoded by a
+    single thread and starts at a cache line, so no bytes are shared between threads, and the segments can be passed
+    to writev or sendmsg as they are. Returns an output without storage for invalid inputs.
+  */
+  SegmentedOutput compress_segments(const T*, std::size_t, std::size_t chunks_per_segment = 16);
+  // decodes the segments in parallel, they do not need to be contiguous in memory
+  std::unique_ptr<T[]> decompress_segments(const std::vector<Segment>&);
+  /*
+    Decodes a stream without a chunk index with several threads. The stream is cut into equal bit ranges and every
+    thread starts decoding at the start of its range, without knowing where a value starts. Prefix codes usually get
+    back in sync after a few values, so the ranges are repaired in order by decoding from the true end of the previous
+    range until a value start of the speculative decode is met. Falls back to decompress for small streams.
+  */
+  std::unique_ptr<T[]> decompress_speculative(const uint8_t*, std::size_t, std::size_t);
+  /*
+    Small message path, taken by compress and decompress below small_message_threshold values. Runs on the calling
+    thread without a parallel region, atomics or temporary allocations, the values are transformed in blocks on the
+    stack and written through a 64 bit window. Encodes into the output_bytes bytes of output, which do not have to be
+    initialized. Returns the number of bytes written, or 0 if a number cannot be encoded or the output does not fit.
+  */
+  std::size_t compress_small(const T*, std::size_t, uint8_t*, std::size_t);
+  // decodes array_length numbers into output on the calling thread
+  void decompress_small(const uint8_t*, std::size_t, T*, std::size_t);
+  virtual CodecId codec_id() const = 0;
+
+  /*
+    Codec specific kernels, the parallel drivers above split the work into chunks.
+
+    chunk_bit_length: number of bits needed to encode array[start, end), sets error on invalid inputs.
+    encode_chunk: encodes array[start_index, end_index) into the bits [start_bit, end_bit) of compressed.
+      The bytes at both ends can be shared with the neighbouring chunks and are only written atomically.
+    encode_values: encodes count numbers at start_bit of an output of output_bytes bytes without atomics, the bits
+      before start_bit are kept. Sets error if a number cannot be encoded or the output does not fit, returns the bit
+      after the last one.
+    decode: decodes array_length numbers from the compressed array of binary_length bytes into output.
+    decode_chunk: decodes count numbers starting at start_bit into output, returns the bit after the last one.
+    decode_range: appends the numbers starting in [start_bit, end_bit) to output, and the start bits of the first
+      max_starts of them to starts, returns the bit after the last one.
+  */
+  virtual std::size_t chunk_bit_length(const T*, std::size_t, std::size_t, bool&) = 0;
+  virtual void encode_chunk(const T*, std::size_t, std::size_t, std::size_t, std::size_t, uint8_t*) = 0;
+  virtual std::size_t encode_values(const T*, std::size_t, uint8_t*, std::size_t, std::size_t, bool&) = 0;
+  virtual void decode(const uint8_t*, std::size_t, T*, std::size_t) = 0;
+  virtual std::size_t decode_chunk(const uint8_t*, std::size_t, std::size_t, T*, std::size_t) = 0;
+  virtual std::size_t decode_range(const uint8_t*, std::size_t, std::size_t, std::size_t, std::vector<T>&,
+                                   std::vector<std::size_t>&, std::size_t) = 0;
   // copy constructor
   EliasBase(EliasBase& other)
-      : Compressor<T>(other), offset(other.offset), map_negative_numbers(other.map_negative_numbers){};
+      : Compressor<T>(other), offset(other.offset), map_negative_numbers(other.map_negative_numbers),
+        batch_size_small(other.batch_size_small), batch_size_large(other.batch_size_large),
+        single_pass(other.single_pass), small_message_threshold(other.small_message_threshold),
+        bit_order(other.bit_order){};
   // move constructor
   EliasBase(EliasBase&& other) noexcept // move constructor
       : Compressor<T>(other), offset(std::exchange(other.offset, 0)),
-        map_negative_numbers(std::exchange(other.map_negative_numbers, false)){};
+        map_negative_numbers(std::exchange(other.map_negative_numbers, false)),
+        batch_size_small(std::exchange(other.batch_size_small, 0)),
+        batch_size_large(std::exchange(other.batch_size_large, 0)),
+        single_pass(std::exchange(other.single_pass, false)),
+        small_message_threshold(std::exchange(other.small_message_threshold, 0)),
+        bit_order(std::exchange(other.bit_order, BitOrder::msb_first)){};
   // copy operator
   EliasBase& operator=(const EliasBase& other) = default;
   EliasBase& operator=(EliasBase&& other) noexcept = default;
 
-protected:
+  // returns a transformed copy of the input, or a nullptr if neither an offset nor the mapping is set
   std::unique_ptr<T[]> transform_array_inputs(const T* input_array, std::size_t& size) {
     std::unique_ptr<T[]> heap_copy_array = nullptr; // TODO change to make_unique_for_overwrite
     if (this->map_negative_numbers || this->offset != 0) {
@@ -63,6 +224,15 @@ protected:
     }
     return heap_copy_array;
   }
+
+  void transform_array_outputs(T* output_array, std::size_t size) {
+    if (this->offset != 0) {
+      this->add_offset(output_array, size, -this->offset);
+    }
+    if (this->map_negative_numbers) {
+      this->transform_to_natural_numbers_reverse(output_array, size);
+    }
+  }
 };
 } // namespace compc
 
@@ -0,0 +1,28 @@
+#ifndef COMPC_ELIAS_FACTORY_H_
+#define COMPC_ELIAS_FACTORY_H_
+#include <cstdint>
+#include <memory>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+namespace compc {
+
+// creates the codec with the given id, returns a nullptr for unknown ids
+template <typename T>
+std::unique_ptr<EliasBase<T>> make_elias(CodecId codec, T zero_offset = 0, bool map_negative_numbers_to_positive = false) {
+  switch (codec) {
+  case CodecId::gamma:
+    return std::make_unique<EliasGamma<T>>(zero_offset, map_negative_numbers_to_positive);
+  case CodecId::delta:
+    return std::make_unique<EliasDelta<T>>(zero_offset, map_negative_numbers_to_positive);
+  case CodecId::omega:
+    return std::make_unique<EliasOmega<T>>(zero_offset, map_negative_numbers_to_positive);
+  }
+  return nullptr;
+}
+
+} // namespace compc
+
+#endif // COMPC_ELIAS_FACTORY_H_
@@ -3,48 +3,64 @@
 #include <cstdint>
 #include <memory>
 #include <tuple>
+#include <vector>
 
 #include "compintc/elias_base.hpp"
 namespace compc {
 
 template <typename T> class EliasGamma : public EliasBase<T> {
 public:
-  uint32_t batch_size_small{50};
-  uint32_t batch_size_large{1000};
   EliasGamma() = default;
   EliasGamma(T zero_offset, bool map_negative_numbers_to_positive)
       : EliasBase<T>(zero_offset, map_negative_numbers_to_positive){};
   EliasGamma(T zero_offset, bool map_negative_numbers_to_positive, uint32_t batch_size_small_p,
              uint32_t batch_size_large_p)
-      : EliasBase<T>(zero_offset, map_negative_numbers_to_positive), batch_size_small(batch_size_small_p),
-        batch_size_large(batch_size_large_p){};
+      : EliasBase<T>(zero_offset, map_negative_numbers_to_positive, batch_size_small_p, batch_size_large_p){};
   ~EliasGamma() = default;
-  std::unique_ptr<uint8_t[]> compress(const T*, std::size_t&) override;
-  std::unique_ptr<T[]> decompress(const uint8_t*, std::size_t, std::size_t) override;
-  std::size_t get_compressed_length(const T*, std::size_t) override;
-  ArrayPrefixSummary get_prefix_sum_array(const T*, std::size_t) override;
+  std::size_t chunk_bit_length(const T*, std::size_t, std::size_t, bool&) override;
+  void encode_chunk(const T*, std::size_t, std::size_t, std::size_t, std::size_t, uint8_t*) override;
+  std::size_t encode_values(const T*, std::size_t, uint8_t*, std::size_t, std::size_t, bool&) override;
+  void decode(const uint8_t*, std::size_t, T*, std::size_t) override;
+  std::size_t decode_chunk(const uint8_t*, std::size_t, std::size_t, T*, std::size_t) override;
+  std::size_t decode_range(const uint8_t*, std::size_t, std::size_t, std::size_t, std::vector<T>&,
+                           std::vector<std::size_t>&, std::size_t) override;
+  /*
+    Interleaved layout for decoders that advance several streams at once: value i goes to lane i % lanes, and the
+    lanes are interleaved in 32 bit words. lanes can be 4, 8 or 16. The words are always MSB-first. Returns a nullptr
+    for other lane counts, a bit_order other than msb_first or numbers that cannot be encoded, the output cannot be
+    read by decompress.
+  */
+  std::unique_ptr<uint8_t[]> compress_lanes(const T*, std::size_t&, uint32_t lanes = 8);
+  // returns a nullptr if the layout is malformed
+  std::unique_ptr<T[]> decompress_lanes(const uint8_t*, std::size_t, std::size_t);
+  CodecId codec_id() const override { return CodecId::gamma; };
   // copy constructor
-  EliasGamma(EliasGamma& other)
-      : EliasBase<T>(other), batch_size_small(other.batch_size_small), batch_size_large(other.batch_size_large){};
+  EliasGamma(EliasGamma& other) : EliasBase<T>(other){};
   // move constructor
-  EliasGamma(EliasGamma&& other) noexcept
-      : EliasBase<T>(other), batch_size_small(std::exchange(batch_size_small, 0)),
-        batch_size_large(std::exchange(batch_size_large, 0)){};
+  EliasGamma(EliasGamma&& other) noexcept : EliasBase<T>(std::move(other)){};
   // copy operator
   EliasGamma& operator=(EliasGamma other) {
     this->num_threads = other.num_threads;
+    this->thread_budget = other.thread_budget;
     this->offset = other.offset;
     this->map_negative_numbers = other.map_negative_numbers;
-    batch_size_small = other.batch_size_small;
-    batch_size_large = other.batch_size_large;
+    this->batch_size_small = other.batch_size_small;
+    this->batch_size_large = other.batch_size_large;
+    this->single_pass = other.single_pass;
+    this->small_message_threshold = other.small_message_threshold;
+    this->bit_order = other.bit_order;
     return *this;
   };
   EliasGamma& operator=(EliasGamma&& other) noexcept {
     this->num_threads = std::move(other.num_threads);
+    this->thread_budget = std::move(other.thread_budget);
     this->offset = std::move(other.offset);
     this->map_negative_numbers = std::move(other.map_negative_numbers);
-    batch_size_small = std::move(other.batch_size_small);
-    batch_size_large = std::move(other.batch_size_large);
+    this->batch_size_small = std::move(other.batch_size_small);
+    this->batch_size_large = std::move(other.batch_size_large);
+    this->single_pass = std::move(other.single_pass);
+    this->small_message_threshold = std::move(other.small_message_threshold);
+    this->bit_order = std::move(other.bit_order);
     return *this;
   };
 };
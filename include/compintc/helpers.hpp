@@ -1,6 +1,8 @@
 #ifndef COMPC_HELPERS_H_
 #define COMPC_HELPERS_H_
+#include <cstddef>
 #include <cstdint>
+#include <type_traits>
 
 namespace hlprs {
 inline int log2(unsigned long long x) {
@@ -11,5 +13,21 @@ inline int log2(unsigned long long x) {
   // in c++20 we could use std::bit_width(index) - 1
 }
 
+// little endian (de)serialization of integers, independent of the host byte order
+template <typename U> inline void store_le(uint8_t* out, U value) {
+  auto bits = static_cast<std::make_unsigned_t<U>>(value);
+  for (std::size_t i = 0; i < sizeof(U); i++) {
+    out[i] = static_cast<uint8_t>(bits >> (8 * i));
+  }
+}
+
+template <typename U> inline U load_le(const uint8_t* in) {
+  std::make_unsigned_t<U> bits = 0;
+  for (std::size_t i = 0; i < sizeof(U); i++) {
+    bits = static_cast<std::make_unsigned_t<U>>(bits | (static_cast<std::make_unsigned_t<U>>(in[i]) << (8 * i)));
+  }
+  return static_cast<U>(bits);
+}
+
 } // namespace hlprs
 #endif // COMPC_HELPERS_H_
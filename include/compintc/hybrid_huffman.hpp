@@ -0,0 +1,60 @@
+#ifndef COMPC_HYBRID_HUFFMAN_H_
+#define COMPC_HYBRID_HUFFMAN_H_
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "compintc/compressor.hpp"
+namespace compc {
+
+/*
+  Gamma-like codec whose length prefixes are entropy coded. Every value v >= 1
+  is written as the canonical Huffman code of N = floor(log2(v)), followed by
+  the N bits of v below its leading 1. The Huffman code is built per block of
+  block_size values from the histogram of N in that block, so skewed length
+  distributions cost far less than the N + 1 bits of the unary prefix of gamma.
+
+  Layout of the compressed array, all integers little endian:
+    uint32 block_size
+    uint32 bytes of every block
+    the blocks, each starting at a byte
+  A block starts with the smallest and the largest N in 6 bits each, followed
+  by the code length of every N in between in 6 bits, 0 for unused lengths.
+  If a block only contains a single N, its code is empty.
+
+  The blocks are sized, encoded and decoded in parallel.
+*/
+template <typename T> class HybridHuffman : public Compressor<T> {
+public:
+  T offset{0};
+  bool map_negative_numbers{false};
+  uint32_t block_size{4096};
+  HybridHuffman() = default;
+  explicit HybridHuffman(T zero_offset) : offset(zero_offset){};
+  HybridHuffman(T zero_offset, bool map_negative_numbers_to_positive)
+      : offset(zero_offset), map_negative_numbers(map_negative_numbers_to_positive){};
+  ~HybridHuffman() = default;
+  // returns a nullptr if the array contains a number that cannot be encoded, size is the compressed size in bytes
+  std::unique_ptr<uint8_t[]> compress(const T*, std::size_t&) override;
+  // returns a nullptr if the array is malformed
+  std::unique_ptr<T[]> decompress(const uint8_t*, std::size_t, std::size_t) override;
+  std::size_t get_compressed_length(const T*, std::size_t) override;
+  // copy constructor
+  HybridHuffman(HybridHuffman& other)
+      : Compressor<T>(other), offset(other.offset), map_negative_numbers(other.map_negative_numbers),
+        block_size(other.block_size){};
+  // move constructor
+  HybridHuffman(HybridHuffman&& other) noexcept
+      : Compressor<T>(other), offset(std::exchange(other.offset, 0)),
+        map_negative_numbers(std::exchange(other.map_negative_numbers, false)),
+        block_size(std::exchange(other.block_size, 0)){};
+  HybridHuffman& operator=(const HybridHuffman& other) = default;
+  HybridHuffman& operator=(HybridHuffman&& other) noexcept = default;
+
+private:
+  // returns a transformed copy of the input, or a nullptr if neither an offset nor the mapping is set
+  std::unique_ptr<T[]> transformed_copy(const T*, std::size_t);
+};
+} // namespace compc
+
+#endif // COMPC_HYBRID_HUFFMAN_H_
@@ -0,0 +1,65 @@
+#ifndef COMPC_INDEX_SET_H_
+#define COMPC_INDEX_SET_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/thread_budget.hpp"
+namespace compc {
+
+// every block covers 2^16 consecutive indices
+constexpr unsigned index_block_bits = 16;
+constexpr std::size_t index_block_size = std::size_t{1} << index_block_bits;
+
+/*
+  Encodings of the indices inside a block, relative to the start of the block:
+  gaps: the first index + 1 followed by the differences, encoded with an Elias codec
+  bitmap: index_block_size bits, 64 bit little endian words
+  runs: (start, length - 1) pairs of little endian uint16
+*/
+enum class BlockContainer : uint8_t { gaps = 0, bitmap = 1, runs = 2 };
+
+struct IndexBlock {
+  uint64_t key = 0; // index >> index_block_bits
+  BlockContainer container = BlockContainer::gaps;
+  uint32_t cardinality = 0;
+  std::size_t offset = 0; // start in the payload in bytes
+  std::size_t bytes = 0;
+};
+
+/*
+  Roaring-style compressed set of indices. The universe is split into blocks
+  and each block uses whichever container is the smallest, so dense regions
+  become bitmaps or runs and sparse regions stay gap-coded.
+*/
+struct CompressedIndexSet {
+  CodecId codec = CodecId::gamma;
+  std::size_t count = 0;
+  std::vector<IndexBlock> blocks{};
+  std::size_t payload_bytes = 0;
+  std::unique_ptr<uint8_t[]> payload{};
+};
+
+/*
+  indices: strictly increasing, non-negative indices
+  length: number of indices
+  codec: Elias codec used for the gap-coded blocks
+  num_threads: threads used for the blocks, 0 uses the default of the compressors
+  thread_budget: if set, the threads are leased from it, see ThreadBudget
+
+  Returns a set with a nullptr as payload if the indices are not strictly increasing or negative.
+*/
+template <typename T>
+CompressedIndexSet compress_index_set(const T* indices, std::size_t length, CodecId codec = CodecId::gamma,
+                                      int num_threads = 0, ThreadBudget* thread_budget = nullptr);
+
+// decodes the blocks in parallel, returns a nullptr if a block does not fit into the payload or the type T
+template <typename T>
+std::unique_ptr<T[]> decompress_index_set(const CompressedIndexSet& set, int num_threads = 0,
+                                          ThreadBudget* thread_budget = nullptr);
+
+} // namespace compc
+
+#endif // COMPC_INDEX_SET_H_
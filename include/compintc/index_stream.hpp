@@ -0,0 +1,147 @@
+#ifndef COMPC_INDEX_STREAM_H_
+#define COMPC_INDEX_STREAM_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+namespace compc {
+
+// number of gaps the readers and writers decode or encode at a time
+constexpr std::size_t stream_block_size = 256;
+
+// where a block of stream_block_size indices of a gap stream starts
+struct GapSkip {
+  uint64_t last = 0;   // the index before the block
+  std::size_t bit = 0; // the first bit of the block
+};
+
+/*
+  Strictly increasing indices as Elias-coded gaps: the first index + 1, then
+  the differences to the previous index. The bits are the same as the output
+  of compress() of the uint64_t gap array with the same codec.
+
+  Skip pointers let readers start decoding at any block. skips[b] describes
+  block b + 1, so there is one for every block but the first. Streams that
+  were written without them have none and are read from the start. They are
+  not part of data, serialize_gap_stream sends them along with the stream.
+*/
+struct GapStream {
+  CodecId codec = CodecId::gamma;
+  std::size_t count = 0;
+  std::vector<uint8_t> data{};
+  std::vector<GapSkip> skips{};
+};
+
+class GapStreamReader {
+  /*
+    Decodes a gap stream block by block, only stream_block_size indices are
+    held in memory at any time.
+  */
+public:
+  explicit GapStreamReader(const GapStream& stream);
+  // false if the codec is unknown or a decoded gap was invalid
+  bool valid() const { return !error; }
+  // reads the next index, returns false at the end of the stream or on an error
+  bool next(uint64_t& index);
+  // reads the first index >= target, returns false if there is none, jumps over whole blocks with the skip pointers
+  bool seek(uint64_t target, uint64_t& index);
+
+private:
+  bool refill();
+  // continues with block b, which has to follow the current block
+  void jump(std::size_t b);
+  std::unique_ptr<EliasBase<uint64_t>> codec{};
+  const uint8_t* data{nullptr};
+  std::size_t length{0};
+  std::size_t count{0};
+  const std::vector<GapSkip>* skips{nullptr};
+  std::size_t remaining{0};
+  std::size_t bit{0};
+  std::vector<uint64_t> block{};
+  std::size_t position{0};
+  uint64_t last{0};
+  bool started{false};
+  bool error{false};
+};
+
+class GapStreamWriter {
+  /*
+    Encodes strictly increasing indices into a gap stream, the gaps are
+    encoded whenever stream_block_size of them are buffered. The skip pointer
+    of a block is recorded when its first index is pushed.
+  */
+public:
+  explicit GapStreamWriter(CodecId codec_id = CodecId::gamma);
+  // returns false if the index is not larger than the previous one
+  bool push(uint64_t index);
+  // returns a nullptr if an invalid index was pushed
+  std::unique_ptr<GapStream> finish();
+
+private:
+  void flush();
+  std::unique_ptr<EliasBase<uint64_t>> codec{};
+  std::unique_ptr<GapStream> stream{};
+  std::vector<uint64_t> gaps{};
+  std::size_t bits{0};
+  uint64_t last{0};
+  bool started{false};
+  bool error{false};
+};
+
+// returns a nullptr if the indices are not strictly increasing or negative
+template <typename T>
+std::unique_ptr<GapStream> encode_gap_stream(const T* indices, std::size_t length, CodecId codec = CodecId::gamma);
+// returns a nullptr if the stream is corrupt or an index does not fit into T
+template <typename T> std::unique_ptr<T[]> decode_gap_stream(const GapStream& stream);
+
+/*
+  Finds the first index >= value without decoding the stream: a binary search over the skip pointers and the decode
+  of a single block, O(log n + stream_block_size). The skip pointers of a stream received from another process are
+  there if it was sent with serialize_gap_stream. Streams without skip pointers are decoded up to the index.
+  Returns false if there is no such index or the stream is corrupt.
+*/
+bool lower_bound(const GapStream& stream, uint64_t value, uint64_t& index);
+// whether the stream holds value, see lower_bound
+bool contains(const GapStream& stream, uint64_t value);
+// adds the skip pointers to a stream written without them, e.g. by select_threshold, returns false if it is corrupt
+bool add_skip_pointers(GapStream& stream);
+
+/*
+  A gap stream as bytes, e.g. to send it to a neighbour. All fields are little endian.
+
+  byte  0: magic "CGS"
+  byte  3: version
+  byte  4: codec id (see CodecId)
+  byte  5: flags, bit 0: skip pointers present
+  byte  6: reserved, 0
+  byte  8: number of indices (uint64)
+  byte 16: size of data in bytes (uint64)
+  byte 24: with skip pointers: for every block but the first, the index before the block and its first bit
+           (uint64 each)
+  followed by data.
+
+  The skip pointers cost 16 bytes per stream_block_size indices. A stream without them, or with skip_pointers
+  false, is written without the table.
+*/
+constexpr uint8_t gap_stream_version = 1;
+constexpr std::size_t gap_stream_header_size = 24;
+
+std::vector<uint8_t> serialize_gap_stream(const GapStream& stream, bool skip_pointers = true);
+// returns a nullptr if the bytes are malformed or truncated, or the skip pointers do not fit the data
+std::unique_ptr<GapStream> deserialize_gap_stream(const uint8_t* bytes, std::size_t length);
+
+/*
+  k-way union and intersection of gap streams. The inputs are decoded block by
+  block and the result is encoded while it is produced, none of the index
+  lists is materialised. Returns a nullptr if an input is corrupt.
+*/
+std::unique_ptr<GapStream> union_streams(const std::vector<const GapStream*>& streams,
+                                         CodecId codec = CodecId::gamma);
+std::unique_ptr<GapStream> intersect_streams(const std::vector<const GapStream*>& streams,
+                                             CodecId codec = CodecId::gamma);
+
+} // namespace compc
+
+#endif // COMPC_INDEX_STREAM_H_
@@ -0,0 +1,46 @@
+#ifndef COMPC_SELECTION_H_
+#define COMPC_SELECTION_H_
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/index_stream.hpp"
+#include "compintc/thread_budget.hpp"
+namespace compc {
+
+// number of dense values every chunk of the selection covers
+constexpr std::size_t selection_chunk_size = std::size_t{1} << 14;
+
+// the selected indices as a gap stream and, if requested, the selected values in the same order
+template <typename V> struct SparseSelection {
+  GapStream indices{};
+  std::vector<V> values{};
+};
+
+/*
+  Selects all indices with |values[i]| >= threshold and encodes them as a gap stream in one parallel pass over
+  the dense array. Every thread keeps the gaps of its chunks, the chunk bit lengths are turned into offsets with
+  a prefix sum and the chunks are encoded in place, so the selected indices are never written to an array of
+  their own.
+
+  num_threads: 0 uses the default of the compressors
+  thread_budget: if set, the threads are leased from it, see ThreadBudget
+*/
+template <typename V>
+SparseSelection<V> select_threshold(const V* values, std::size_t length, V threshold, CodecId codec = CodecId::gamma,
+                                    bool keep_values = false, int num_threads = 0,
+                                    ThreadBudget* thread_budget = nullptr);
+
+/*
+  Selects the k indices with the largest |values[i]|, ties are broken by the smaller index. The threshold is
+  found by a radix selection on the bits of the magnitudes before the fused pass, with per thread histograms and a
+  gathered set of candidates instead of a copy of the array. The values must not be NaN.
+*/
+template <typename V>
+SparseSelection<V> select_top_k(const V* values, std::size_t length, std::size_t k, CodecId codec = CodecId::gamma,
+                                bool keep_values = false, int num_threads = 0, ThreadBudget* thread_budget = nullptr);
+
+} // namespace compc
+
+#endif // COMPC_SELECTION_H_
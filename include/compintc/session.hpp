@@ -0,0 +1,73 @@
+#ifndef COMPC_SESSION_H_
+#define COMPC_SESSION_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/index_stream.hpp"
+namespace compc {
+
+/*
+  The change of an index set from one round to the next. In a keyframe the
+  insertions are the whole set and the deletions are empty.
+*/
+struct SessionDelta {
+  uint64_t round = 0;
+  bool keyframe = false;
+  GapStream insertions{};
+  GapStream deletions{};
+};
+
+class SessionEncoder {
+  /*
+    Sends a sequence of index sets to a single peer. The set of the previous
+    round is kept as a gap stream, and every round only the indices that were
+    inserted or deleted since then are encoded. If that is not smaller than
+    the whole set, a keyframe is sent instead. Use one encoder per peer.
+  */
+public:
+  explicit SessionEncoder(CodecId codec_id = CodecId::gamma) : codec(codec_id) {}
+  // returns a nullptr and keeps the state if the indices are not strictly increasing or negative
+  template <typename T> std::unique_ptr<SessionDelta> encode(const T* indices, std::size_t length);
+  // the next round is sent as a keyframe, e.g. after the peer lost a delta
+  void reset() { force_keyframe = true; }
+  uint64_t round() const { return rounds; }
+  const GapStream& state() const { return previous; }
+
+private:
+  CodecId codec;
+  GapStream previous{};
+  uint64_t rounds{0};
+  bool force_keyframe{true};
+};
+
+class SessionDecoder {
+  /*
+    Mirrors the state of the SessionEncoder of a peer, the deltas have to be
+    applied in the order of their rounds.
+  */
+public:
+  explicit SessionDecoder(CodecId codec_id = CodecId::gamma) : codec(codec_id) { current.codec = codec_id; }
+  /*
+    Applies the delta of the next round. Returns false and keeps the state if
+    the delta is corrupt, is not of the next round, deletes an index that is
+    not in the set or inserts one that is. After a lost delta, only a keyframe
+    of a later round is accepted.
+  */
+  bool apply(const SessionDelta& delta);
+  // returns a nullptr if an index does not fit into T
+  template <typename T> std::unique_ptr<T[]> indices() const { return decode_gap_stream<T>(current); }
+  std::size_t size() const { return current.count; }
+  uint64_t round() const { return rounds; }
+  const GapStream& state() const { return current; }
+
+private:
+  CodecId codec;
+  GapStream current{};
+  uint64_t rounds{0};
+};
+
+} // namespace compc
+
+#endif // COMPC_SESSION_H_
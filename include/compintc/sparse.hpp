@@ -0,0 +1,59 @@
+#ifndef COMPC_SPARSE_H_
+#define COMPC_SPARSE_H_
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+namespace compc {
+
+// sparse matrix in compressed sparse row format, row_ptr has rows + 1 entries
+template <typename T> struct CsrMatrix {
+  std::size_t rows = 0;
+  std::size_t nnz = 0;
+  std::unique_ptr<T[]> row_ptr{};
+  std::unique_ptr<T[]> col_idx{};
+};
+
+/*
+  A CSR matrix encoded as one stream of positive numbers. Every row contributes its number of non-zeros + 1,
+  followed by its column indices as gaps: the first column + 1, then the difference to the previous column.
+  The rows are grouped into blocks of roughly equal size, and every block is encoded as an independent chunk,
+  so the matrix can be decoded in parallel by row ranges.
+*/
+struct CompressedCsr {
+  std::size_t rows = 0;
+  std::size_t nnz = 0;
+  std::size_t payload_bytes = 0;
+  std::unique_ptr<uint8_t[]> payload{};
+  // per block: the first row, the number of non-zeros before it and the bit where it ends
+  std::vector<std::size_t> block_rows{};
+  std::vector<std::size_t> block_nnz{};
+  std::vector<std::size_t> block_end_bits{};
+};
+
+/*
+  codec: codec whose kernels, number of threads and batch_size_large are used. Its offset and mapping are ignored,
+    the encoded numbers are positive by construction.
+  row_ptr: rows + 1 non-decreasing row pointers
+  col_idx: column indices, strictly increasing within each row
+
+  Returns a CompressedCsr with a nullptr as payload if the matrix is not a valid CSR matrix.
+*/
+template <typename T>
+CompressedCsr compress_csr(EliasBase<T>& codec, const T* row_ptr, const T* col_idx, std::size_t rows);
+
+/*
+  Decodes the blocks in parallel, the row pointers of the result start at 0.
+  Returns a matrix with a nullptr as row_ptr if the blocks do not match the payload.
+*/
+template <typename T> CsrMatrix<T> decompress_csr(EliasBase<T>& codec, const CompressedCsr& compressed);
+
+// sorts coordinate format entries into a CSR matrix, the row indices must be smaller than rows
+template <typename T>
+CsrMatrix<T> coo_to_csr(const T* row_idx, const T* col_idx, std::size_t nnz, std::size_t rows);
+
+} // namespace compc
+
+#endif // COMPC_SPARSE_H_
@@ -0,0 +1,76 @@
+#ifndef COMPC_STATS_H_
+#define COMPC_STATS_H_
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace compc {
+
+/*
+  Performance counters of the last compress or decompress call of a
+  compressor. A compressor only fills them in when its stats pointer is set,
+  otherwise no clock is read and nothing is recorded.
+
+  All durations are in nanoseconds.
+*/
+struct CompressionStats {
+  // compress phases
+  uint64_t transform_ns = 0;  // offset and mapping of negative numbers
+  uint64_t sizing_ns = 0;     // get_prefix_sum_array
+  uint64_t allocation_ns = 0; // allocation of the output array
+  uint64_t encode_ns = 0;     // parallel encoding of the chunks
+  // decompress phases
+  uint64_t decode_ns = 0;
+  uint64_t post_transform_ns = 0; // reverting the offset and the mapping
+  std::size_t total_chunks = 0;
+  uint32_t batch_size = 0;
+  int threads_used = 0;
+  double bits_per_value = 0.0;
+  // number of chunks each thread of the encode loop processed
+  std::vector<std::size_t> chunks_per_thread{};
+
+  void reset() {
+    transform_ns = 0;
+    sizing_ns = 0;
+    allocation_ns = 0;
+    encode_ns = 0;
+    decode_ns = 0;
+    post_transform_ns = 0;
+    total_chunks = 0;
+    batch_size = 0;
+    threads_used = 0;
+    bits_per_value = 0.0;
+    chunks_per_thread.clear();
+  }
+};
+
+class PhaseTimer {
+  /*
+    Attributes the time since the previous lap to a phase of the stats.
+    Does nothing if stats is a nullptr.
+  */
+public:
+  explicit PhaseTimer(CompressionStats* phase_stats) : stats(phase_stats) {
+    if (stats != nullptr) {
+      last = std::chrono::steady_clock::now();
+    }
+  }
+
+  void lap(uint64_t CompressionStats::*phase) {
+    if (stats == nullptr) {
+      return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    stats->*phase += static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - last).count());
+    last = now;
+  }
+
+private:
+  CompressionStats* stats;
+  std::chrono::steady_clock::time_point last{};
+};
+
+} // namespace compc
+
+#endif // COMPC_STATS_H_
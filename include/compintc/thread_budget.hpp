@@ -0,0 +1,71 @@
+#ifndef COMPC_THREAD_BUDGET_H_
+#define COMPC_THREAD_BUDGET_H_
+#include <atomic>
+#include <cstdint>
+
+namespace compc {
+
+class ThreadBudget {
+  /*
+    A number of threads shared by compressors that are called concurrently,
+    e.g. from several I/O threads. Every compress or decompress call of a
+    compressor whose thread_budget points here leases the threads of its
+    parallel regions from the budget and returns them when it completes, so
+    the calls together do not use more threads than the budget holds.
+
+    Leasing never blocks. A call that finds the budget used up runs on its
+    own thread, which exists anyway, instead of waiting for other calls.
+  */
+public:
+  // threads 0 uses all hardware threads
+  explicit ThreadBudget(int threads = 0);
+  ThreadBudget(const ThreadBudget&) = delete;
+  ThreadBudget& operator=(const ThreadBudget&) = delete;
+
+  int capacity() const { return total; }
+  // threads that are not leased at the moment
+  int available() const { return free.load(std::memory_order_relaxed); }
+
+  // a budget of all hardware threads for the whole process
+  static ThreadBudget& process();
+
+private:
+  friend class ThreadLease;
+  // takes up to wanted threads, returns how many were taken, possibly 0
+  int acquire(int wanted);
+  void release(int threads);
+
+  int total{1};
+  std::atomic<int> free{1};
+};
+
+class ThreadLease {
+  /*
+    The threads of one call, leased from a budget for the lifetime of the
+    lease. While a lease is alive on a thread, Compressor::threads() of every
+    compressor called on that thread is limited to the leased threads.
+    Leases are not nested: one taken while another is alive on the same
+    thread, e.g. by compress calling encode_single_pass, leases nothing.
+    Without a budget the lease does nothing.
+  */
+public:
+  ThreadLease(ThreadBudget* budget, int wanted);
+  ThreadLease(const ThreadLease&) = delete;
+  ThreadLease& operator=(const ThreadLease&) = delete;
+  ~ThreadLease();
+
+  /*
+    Threads a call that wants the given number may use on the calling thread: 1 inside a parallel region, so
+    compressors called from one do not nest teams, at most the leased threads while a lease is alive, and wanted
+    otherwise.
+  */
+  static int limit(int wanted);
+
+private:
+  ThreadBudget* owner{nullptr};
+  int taken{0};
+};
+
+} // namespace compc
+
+#endif // COMPC_THREAD_BUDGET_H_
@@ -0,0 +1,80 @@
+#include "compintc/async.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+compc::AsyncExecutor::AsyncExecutor(int threads, int max_in_flight)
+    : own_budget(std::make_unique<ThreadBudget>(threads)), shared_budget(own_budget.get()) {
+  this->start(max_in_flight);
+}
+
+compc::AsyncExecutor::AsyncExecutor(ThreadBudget& budget, int max_in_flight) : shared_budget(&budget) {
+  this->start(max_in_flight);
+}
+
+void compc::AsyncExecutor::start(int max_in_flight) {
+  int capacity = shared_budget->capacity();
+  int in_flight = std::clamp(max_in_flight, 1, capacity);
+  operation_threads = std::max(capacity / in_flight, 1);
+  workers.reserve(static_cast<std::size_t>(in_flight));
+  for (int w = 0; w < in_flight; w++) {
+    workers.emplace_back(&AsyncExecutor::work, this);
+  }
+}
+
+compc::AsyncExecutor::~AsyncExecutor() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  task_available.notify_all();
+  for (std::thread& worker : workers) {
+    worker.join();
+  }
+}
+
+void compc::AsyncExecutor::submit(std::function<void(int)> task) {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(std::move(task));
+  }
+  task_available.notify_one();
+}
+
+void compc::AsyncExecutor::wait_idle() {
+  std::unique_lock<std::mutex> lock(mutex);
+  idle.wait(lock, [this] { return tasks.empty() && running == 0; });
+}
+
+void compc::AsyncExecutor::work() {
+  while (true) {
+    std::function<void(int)> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      // remaining tasks are still completed when stopping
+      task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+      if (tasks.empty()) {
+        return;
+      }
+      task = std::move(tasks.front());
+      tasks.pop_front();
+      running++;
+    }
+    try {
+      // the OpenMP teams of the operation are limited to the leased threads
+      ThreadLease lease(shared_budget, operation_threads);
+      task(ThreadLease::limit(operation_threads));
+    } catch (...) {
+      // a throwing callback must not end the worker, the operation counts as completed
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      running--;
+    }
+    idle.notify_all();
+  }
+}
@@ -0,0 +1,146 @@
+#include "compintc/buffer_cache.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+#include "compintc/helpers.hpp"
+
+namespace {
+constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+
+inline uint64_t rotate_left(uint64_t x, uint32_t bits) { return (x << bits) | (x >> (64U - bits)); }
+
+// finalizer of MurmurHash3, every input bit affects every output bit
+inline uint64_t avalanche(uint64_t x) {
+  x ^= x >> 33U;
+  x *= 0xFF51AFD7ED558CCDULL;
+  x ^= x >> 33U;
+  x *= 0xC4CEB9FE1A85EC53ULL;
+  x ^= x >> 33U;
+  return x;
+}
+
+/*
+  Two independent 64 bit hashes of the bytes, computed in one pass over 8 byte words. The two chains do not depend on
+  each other, so their multiplications overlap and the hash runs at several bytes per cycle.
+*/
+void content_hash(const uint8_t* data, std::size_t length, uint64_t& low, uint64_t& high) {
+  uint64_t a = prime_1 ^ length;
+  uint64_t b = prime_2 + length;
+  std::size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    uint64_t word = hlprs::load_le<uint64_t>(data + i);
+    a = rotate_left(a ^ (word * prime_3), 31) * prime_1;
+    b = rotate_left(b + (word * prime_4), 27) * prime_2;
+  }
+  uint64_t tail = 0;
+  for (uint32_t shift = 0; i < length; i++, shift += 8) {
+    tail |= uint64_t{data[i]} << shift;
+  }
+  a = rotate_left(a ^ (tail * prime_3), 31) * prime_1;
+  b = rotate_left(b + (tail * prime_4), 27) * prime_2;
+  low = avalanche(a ^ rotate_left(b, 17));
+  high = avalanche(b + a);
+}
+} // namespace
+
+bool compc::BufferCache::Key::operator==(const Key& other) const {
+  return hash_low == other.hash_low && hash_high == other.hash_high && values == other.values &&
+         offset == other.offset && codec == other.codec && type_width == other.type_width &&
+         type_signed == other.type_signed && map_negative_numbers == other.map_negative_numbers &&
+         bit_order == other.bit_order;
+}
+
+compc::BufferCache::BufferCache(std::size_t capacity) : capacity_bytes(capacity) {}
+
+compc::BufferCacheStats compc::BufferCache::stats() const {
+  std::lock_guard<std::mutex> lock(mutex);
+  return counters;
+}
+
+void compc::BufferCache::clear() {
+  std::lock_guard<std::mutex> lock(mutex);
+  index.clear();
+  entries.clear();
+  counters.entries = 0;
+  counters.bytes = 0;
+}
+
+compc::CachedBuffer compc::BufferCache::find(const Key& key) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = index.find(key);
+  if (found == index.end()) {
+    counters.misses++;
+    return nullptr;
+  }
+  counters.hits++;
+  entries.splice(entries.begin(), entries, found->second);
+  return found->second->buffer;
+}
+
+compc::CachedBuffer compc::BufferCache::insert(const Key& key, CachedBuffer buffer) {
+  std::lock_guard<std::mutex> lock(mutex);
+  auto found = index.find(key);
+  if (found != index.end()) {
+    // compressed by another thread in the meantime
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->buffer;
+  }
+  if (buffer->size > capacity_bytes) {
+    return buffer;
+  }
+  entries.push_front(Entry{key, buffer});
+  index.emplace(key, entries.begin());
+  counters.entries++;
+  counters.bytes += buffer->size;
+  while (counters.bytes > capacity_bytes) {
+    const Entry& oldest = entries.back();
+    counters.bytes -= oldest.buffer->size;
+    counters.entries--;
+    counters.evictions++;
+    index.erase(oldest.key);
+    entries.pop_back();
+  }
+  return buffer;
+}
+
+template <typename T>
+compc::CachedBuffer compc::BufferCache::compress(EliasBase<T>& codec, const T* array, std::size_t size) {
+  Key key{};
+  content_hash(reinterpret_cast<const uint8_t*>(array), size * sizeof(T), key.hash_low, key.hash_high);
+  key.values = size;
+  key.offset = static_cast<int64_t>(codec.offset);
+  key.codec = static_cast<uint8_t>(codec.codec_id());
+  key.type_width = sizeof(T);
+  key.type_signed = std::is_signed_v<T>;
+  key.map_negative_numbers = codec.map_negative_numbers;
+  key.bit_order = static_cast<uint8_t>(codec.bit_order);
+  CachedBuffer cached = this->find(key);
+  if (cached != nullptr) {
+    return cached;
+  }
+  auto buffer = std::make_shared<CompressedBytes>();
+  buffer->size = size;
+  buffer->values = size;
+  buffer->data = codec.compress(array, buffer->size);
+  if (buffer->data == nullptr) {
+    return nullptr;
+  }
+  return this->insert(key, std::move(buffer));
+}
+
+template compc::CachedBuffer compc::BufferCache::compress<int16_t>(EliasBase<int16_t>&, const int16_t*, std::size_t);
+template compc::CachedBuffer compc::BufferCache::compress<uint16_t>(EliasBase<uint16_t>&, const uint16_t*,
+                                                                    std::size_t);
+template compc::CachedBuffer compc::BufferCache::compress<int32_t>(EliasBase<int32_t>&, const int32_t*, std::size_t);
+template compc::CachedBuffer compc::BufferCache::compress<uint32_t>(EliasBase<uint32_t>&, const uint32_t*,
+                                                                    std::size_t);
+template compc::CachedBuffer compc::BufferCache::compress<int64_t>(EliasBase<int64_t>&, const int64_t*, std::size_t);
+template compc::CachedBuffer compc::BufferCache::compress<uint64_t>(EliasBase<uint64_t>&, const uint64_t*,
+                                                                    std::size_t);
@@ -0,0 +1,300 @@
+#include "compintc/container.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "compintc/crc32c.hpp"
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+#include "compintc/helpers.hpp"
+
+namespace {
+constexpr uint8_t magic[3] = {'C', 'I', 'C'};
+constexpr uint8_t flag_map_negative_numbers = 1U;
+constexpr uint8_t flag_chunk_index = 1U << 1U;
+constexpr uint8_t flag_checksums = 1U << 2U;
+constexpr uint8_t flag_lsb_first = 1U << 3U;
+constexpr uint8_t type_signed_bit = 0x80U;
+} // namespace
+
+std::size_t compc::FrameHeader::header_bytes() const {
+  std::size_t index_bytes = has_chunk_index ? static_cast<std::size_t>(chunk_count) * sizeof(uint32_t) : 0;
+  std::size_t checksum_bytes = has_checksums ? index_bytes + sizeof(uint32_t) : 0;
+  return frame_header_size + index_bytes + checksum_bytes;
+}
+
+bool compc::read_chunk_end_bits(const uint8_t* frame, const FrameHeader& header, std::vector<std::size_t>& end_bits) {
+  end_bits.resize(header.chunk_count);
+  std::size_t end_bit = 0;
+  for (std::size_t i = 0; i < header.chunk_count; i++) {
+    end_bit += hlprs::load_le<uint32_t>(frame + frame_header_size + i * sizeof(uint32_t));
+    end_bits[i] = end_bit;
+  }
+  return end_bit <= header.payload_bytes * 8;
+}
+
+namespace {
+std::vector<uint32_t> read_chunk_checksums(const uint8_t* frame, const compc::FrameHeader& header) {
+  std::vector<uint32_t> checksums(header.chunk_count);
+  const uint8_t* start = frame + compc::frame_header_size + header.chunk_count * sizeof(uint32_t);
+  for (std::size_t i = 0; i < header.chunk_count; i++) {
+    checksums[i] = hlprs::load_le<uint32_t>(start + i * sizeof(uint32_t));
+  }
+  return checksums;
+}
+} // namespace
+
+void compc::write_frame_header(uint8_t* frame, const FrameHeader& header) {
+  std::memcpy(frame, magic, sizeof(magic));
+  frame[3] = header.version;
+  frame[4] = static_cast<uint8_t>(header.codec);
+  frame[5] = static_cast<uint8_t>(header.type_width | (header.type_signed ? type_signed_bit : 0U));
+  frame[6] = static_cast<uint8_t>((header.map_negative_numbers ? flag_map_negative_numbers : 0U) |
+                                  (header.has_chunk_index ? flag_chunk_index : 0U) |
+                                  (header.has_checksums ? flag_checksums : 0U) |
+                                  (header.bit_order == BitOrder::lsb_first ? flag_lsb_first : 0U));
+  frame[7] = 0;
+  hlprs::store_le<uint64_t>(frame + 8, header.count);
+  hlprs::store_le<int64_t>(frame + 16, header.offset);
+  hlprs::store_le<uint64_t>(frame + 24, header.payload_bytes);
+  hlprs::store_le<uint32_t>(frame + 32, header.batch_size);
+  hlprs::store_le<uint32_t>(frame + 36, header.chunk_count);
+}
+
+bool compc::read_frame_header(const uint8_t* frame, std::size_t frame_length, FrameHeader& header) {
+  if (frame == nullptr || frame_length < frame_header_size || std::memcmp(frame, magic, sizeof(magic)) != 0) {
+    return false;
+  }
+  header.version = frame[3];
+  if (header.version != frame_version) {
+    return false;
+  }
+  if (frame[4] < static_cast<uint8_t>(CodecId::gamma) || frame[4] > static_cast<uint8_t>(CodecId::omega)) {
+    return false;
+  }
+  header.codec = static_cast<CodecId>(frame[4]);
+  header.type_width = static_cast<uint8_t>(frame[5] & ~type_signed_bit);
+  header.type_signed = (frame[5] & type_signed_bit) != 0;
+  if (header.type_width != 2 && header.type_width != 4 && header.type_width != 8) {
+    return false;
+  }
+  header.map_negative_numbers = (frame[6] & flag_map_negative_numbers) != 0;
+  header.has_chunk_index = (frame[6] & flag_chunk_index) != 0;
+  header.has_checksums = (frame[6] & flag_checksums) != 0;
+  header.bit_order = (frame[6] & flag_lsb_first) != 0 ? BitOrder::lsb_first : BitOrder::msb_first;
+  if (header.has_checksums && !header.has_chunk_index) {
+    return false;
+  }
+  header.count = hlprs::load_le<uint64_t>(frame + 8);
+  header.offset = hlprs::load_le<int64_t>(frame + 16);
+  header.payload_bytes = hlprs::load_le<uint64_t>(frame + 24);
+  header.batch_size = hlprs::load_le<uint32_t>(frame + 32);
+  header.chunk_count = hlprs::load_le<uint32_t>(frame + 36);
+  if (header.has_chunk_index) {
+    if (header.batch_size == 0 || header.chunk_count != (header.count + header.batch_size - 1) / header.batch_size) {
+      return false;
+    }
+  }
+  // every value takes at least one bit
+  if (header.payload_bytes > frame_length || header.count > header.payload_bytes * 8) {
+    return false;
+  }
+  std::size_t header_bytes = header.header_bytes();
+  if (header_bytes > frame_length - header.payload_bytes) {
+    return false;
+  }
+  if (header.has_checksums) {
+    std::size_t checksum_offset = header_bytes - sizeof(uint32_t);
+    return compc::crc32c(frame, checksum_offset) == hlprs::load_le<uint32_t>(frame + checksum_offset);
+  }
+  return true;
+}
+
+bool compc::verify_frame(const uint8_t* frame, std::size_t frame_length, std::vector<std::size_t>* corrupt_chunks,
+                         int num_threads, ThreadBudget* thread_budget) {
+  FrameHeader header;
+  if (!read_frame_header(frame, frame_length, header)) {
+    return false;
+  }
+  if (!header.has_checksums) {
+    return true;
+  }
+  std::vector<std::size_t> chunk_end_bits;
+  if (!read_chunk_end_bits(frame, header, chunk_end_bits)) {
+    return false;
+  }
+  std::vector<uint32_t> checksums = read_chunk_checksums(frame, header);
+  const uint8_t* payload = frame + header.header_bytes();
+  std::vector<std::size_t> corrupt{};
+  auto total_chunks = static_cast<std::ptrdiff_t>(header.chunk_count);
+  const bool lsb_first = header.bit_order == BitOrder::lsb_first;
+  if (num_threads <= 0) {
+    num_threads = default_num_threads();
+  }
+  compc::ThreadLease lease(thread_budget, num_threads);
+  int local_threads = compc::ThreadLease::limit(num_threads);
+  if (total_chunks < local_threads) {
+    local_threads = std::max(static_cast<int>(total_chunks), 1);
+  }
+#pragma omp parallel for schedule(static) default(none) shared(payload, chunk_end_bits, checksums, corrupt)            \
+    firstprivate(total_chunks, lsb_first) num_threads(local_threads)
+  for (std::ptrdiff_t round = 0; round < total_chunks; round++) {
+    auto chunk = static_cast<std::size_t>(round);
+    std::size_t start_bit = (chunk == 0) ? 0 : chunk_end_bits[chunk - 1];
+    if (compc::crc32c_bits(payload, start_bit, chunk_end_bits[chunk], lsb_first) != checksums[chunk]) {
+#pragma omp critical
+      corrupt.push_back(chunk);
+    }
+  }
+  std::sort(corrupt.begin(), corrupt.end());
+  if (corrupt_chunks != nullptr) {
+    corrupt_chunks->insert(corrupt_chunks->end(), corrupt.begin(), corrupt.end());
+  }
+  return corrupt.empty();
+}
+
+template <typename T>
+std::unique_ptr<uint8_t[]> compc::compress_framed(EliasBase<T>& codec, const T* input_array, std::size_t& size,
+                                                  bool chunk_index, bool checksums) {
+  // one lease for the sizing and the encode, the ones taken by the codec are nested and lease nothing
+  compc::ThreadLease lease(codec.thread_budget, codec.num_threads);
+  const std::size_t N = size;
+  FrameHeader header;
+  header.codec = codec.codec_id();
+  header.type_width = sizeof(T);
+  header.type_signed = std::is_signed_v<T>;
+  header.map_negative_numbers = codec.map_negative_numbers;
+  header.bit_order = codec.bit_order;
+  header.count = N;
+  header.offset = static_cast<int64_t>(codec.offset);
+  if (N == 0) {
+    std::unique_ptr<uint8_t[]> frame = std::make_unique<uint8_t[]>(frame_header_size);
+    write_frame_header(frame.get(), header);
+    size = frame_header_size;
+    return frame;
+  }
+
+  std::unique_ptr<T[]> heap_copy_array = codec.transform_array_inputs(input_array, size);
+  const T* array = (heap_copy_array != nullptr) ? heap_copy_array.get() : input_array;
+  ArrayPrefixSummary prefix_tuple = codec.get_prefix_sum_array(array, N); // in bits
+  if (prefix_tuple.error) {
+    return nullptr;
+  }
+  const std::vector<std::size_t>& prefix_array = prefix_tuple.local_sums;
+  header.payload_bytes = (prefix_array[prefix_tuple.total_chunks - 1] + 7) / 8;
+  header.has_chunk_index = chunk_index && prefix_tuple.total_chunks <= std::numeric_limits<uint32_t>::max();
+  std::size_t previous = 0;
+  for (std::size_t i = 0; header.has_chunk_index && i < prefix_tuple.total_chunks; i++) {
+    // chunks longer than 2^32 bits cannot be indexed
+    header.has_chunk_index = prefix_array[i] - previous <= std::numeric_limits<uint32_t>::max();
+    previous = prefix_array[i];
+  }
+  if (header.has_chunk_index) {
+    header.batch_size = prefix_tuple.batch_size;
+    header.chunk_count = static_cast<uint32_t>(prefix_tuple.total_chunks);
+    header.has_checksums = checksums;
+  }
+
+  const std::size_t header_bytes = header.header_bytes();
+  // zero initialize, the chunks are or-ed into the payload
+  std::unique_ptr<uint8_t[]> frame = std::make_unique<uint8_t[]>(header_bytes + header.payload_bytes);
+  write_frame_header(frame.get(), header);
+  previous = 0;
+  for (std::size_t i = 0; i < header.chunk_count; i++) {
+    hlprs::store_le<uint32_t>(frame.get() + frame_header_size + i * sizeof(uint32_t),
+                              static_cast<uint32_t>(prefix_array[i] - previous));
+    previous = prefix_array[i];
+  }
+  EncodeHooks hooks;
+  std::vector<uint32_t> chunk_checksums{};
+  if (header.has_checksums) {
+    chunk_checksums.resize(header.chunk_count);
+    hooks.chunk_checksums = chunk_checksums.data();
+  }
+  codec.encode_chunks(array, N, prefix_tuple, frame.get() + header_bytes, hooks);
+  if (header.has_checksums) {
+    uint8_t* checksum_start = frame.get() + frame_header_size + header.chunk_count * sizeof(uint32_t);
+    for (std::size_t i = 0; i < header.chunk_count; i++) {
+      hlprs::store_le<uint32_t>(checksum_start + i * sizeof(uint32_t), chunk_checksums[i]);
+    }
+    std::size_t checksum_offset = header_bytes - sizeof(uint32_t);
+    hlprs::store_le<uint32_t>(frame.get() + checksum_offset, compc::crc32c(frame.get(), checksum_offset));
+  }
+  size = header_bytes + header.payload_bytes;
+  return frame;
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::decompress_auto(const uint8_t* frame, std::size_t frame_length, std::size_t& array_length,
+                                            int num_threads, std::vector<std::size_t>* corrupt_chunks,
+                                            ThreadBudget* thread_budget) {
+  FrameHeader header;
+  if (!read_frame_header(frame, frame_length, header)) {
+    return nullptr;
+  }
+  if (header.type_width != sizeof(T) || header.type_signed != std::is_signed_v<T>) {
+    return nullptr;
+  }
+  std::unique_ptr<EliasBase<T>> codec =
+      make_elias<T>(header.codec, static_cast<T>(header.offset), header.map_negative_numbers);
+  codec->bit_order = header.bit_order;
+  codec->thread_budget = thread_budget;
+  if (num_threads > 0) {
+    codec->num_threads = num_threads;
+  }
+  const uint8_t* payload = frame + header.header_bytes();
+  array_length = header.count;
+  if (header.count == 0) {
+    return std::unique_ptr<T[]>(new T[0]);
+  }
+  if (!header.has_chunk_index) {
+    return codec->decompress_speculative(payload, header.payload_bytes, header.count);
+  }
+
+  std::vector<std::size_t> chunk_end_bits;
+  if (!read_chunk_end_bits(frame, header, chunk_end_bits)) {
+    return nullptr;
+  }
+  std::vector<uint32_t> checksums{};
+  if (header.has_checksums) {
+    checksums = read_chunk_checksums(frame, header);
+  }
+  std::unique_ptr<T[]> uncomp(new T[header.count]);
+  if (!codec->decode_chunks(payload, header.payload_bytes, chunk_end_bits, header.batch_size, uncomp.get(),
+                            header.count, header.has_checksums ? checksums.data() : nullptr, corrupt_chunks)) {
+    return nullptr;
+  }
+  codec->transform_array_outputs(uncomp.get(), header.count);
+  return uncomp;
+}
+
+template std::unique_ptr<uint8_t[]> compc::compress_framed<int16_t>(EliasBase<int16_t>&, const int16_t*, std::size_t&,
+                                                                    bool, bool);
+template std::unique_ptr<uint8_t[]> compc::compress_framed<uint16_t>(EliasBase<uint16_t>&, const uint16_t*,
+                                                                     std::size_t&, bool, bool);
+template std::unique_ptr<uint8_t[]> compc::compress_framed<int32_t>(EliasBase<int32_t>&, const int32_t*, std::size_t&,
+                                                                    bool, bool);
+template std::unique_ptr<uint8_t[]> compc::compress_framed<uint32_t>(EliasBase<uint32_t>&, const uint32_t*,
+                                                                     std::size_t&, bool, bool);
+template std::unique_ptr<uint8_t[]> compc::compress_framed<int64_t>(EliasBase<int64_t>&, const int64_t*, std::size_t&,
+                                                                    bool, bool);
+template std::unique_ptr<uint8_t[]> compc::compress_framed<uint64_t>(EliasBase<uint64_t>&, const uint64_t*,
+                                                                     std::size_t&, bool, bool);
+
+template std::unique_ptr<int16_t[]> compc::decompress_auto<int16_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                    std::vector<std::size_t>*, ThreadBudget*);
+template std::unique_ptr<uint16_t[]> compc::decompress_auto<uint16_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                      std::vector<std::size_t>*, ThreadBudget*);
+template std::unique_ptr<int32_t[]> compc::decompress_auto<int32_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                    std::vector<std::size_t>*, ThreadBudget*);
+template std::unique_ptr<uint32_t[]> compc::decompress_auto<uint32_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                      std::vector<std::size_t>*, ThreadBudget*);
+template std::unique_ptr<int64_t[]> compc::decompress_auto<int64_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                    std::vector<std::size_t>*, ThreadBudget*);
+template std::unique_ptr<uint64_t[]> compc::decompress_auto<uint64_t>(const uint8_t*, std::size_t, std::size_t&, int,
+                                                                      std::vector<std::size_t>*, ThreadBudget*);
@@ -0,0 +1,132 @@
+#include "compintc/crc32c.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#  define COMPC_CRC32C_SSE42
+#  include <nmmintrin.h>
+#endif
+
+namespace {
+
+constexpr uint32_t polynomial = 0x82F63B78U; // reversed Castagnoli polynomial
+
+using Table = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Table make_table() {
+  Table table{};
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int j = 0; j < 8; j++) {
+      crc = (crc >> 1U) ^ ((crc & 1U) ? polynomial : 0U);
+    }
+    table[0][i] = crc;
+  }
+  for (std::size_t i = 0; i < 256; i++) {
+    for (std::size_t k = 1; k < 8; k++) {
+      table[k][i] = (table[k - 1][i] >> 8U) ^ table[0][table[k - 1][i] & 0xFFU];
+    }
+  }
+  return table;
+}
+
+constexpr Table table = make_table();
+
+uint32_t update_portable(uint32_t crc, const uint8_t* data, std::size_t length) {
+  // slicing-by-8
+  while (length >= 8) {
+    uint32_t low = crc ^ (static_cast<uint32_t>(data[0]) | (static_cast<uint32_t>(data[1]) << 8U) |
+                          (static_cast<uint32_t>(data[2]) << 16U) | (static_cast<uint32_t>(data[3]) << 24U));
+    crc = table[7][low & 0xFFU] ^ table[6][(low >> 8U) & 0xFFU] ^ table[5][(low >> 16U) & 0xFFU] ^
+          table[4][low >> 24U] ^ table[3][data[4]] ^ table[2][data[5]] ^ table[1][data[6]] ^ table[0][data[7]];
+    data += 8;
+    length -= 8;
+  }
+  while (length > 0) {
+    crc = (crc >> 8U) ^ table[0][(crc ^ *data) & 0xFFU];
+    data++;
+    length--;
+  }
+  return crc;
+}
+
+#ifdef COMPC_CRC32C_SSE42
+__attribute__((target("sse4.2"))) uint32_t update_sse42(uint32_t crc, const uint8_t* data, std::size_t length) {
+  uint64_t crc64 = crc;
+  while (length >= 8) {
+    uint64_t word = 0;
+    std::memcpy(&word, data, sizeof(word));
+    crc64 = _mm_crc32_u64(crc64, word);
+    data += 8;
+    length -= 8;
+  }
+  auto crc32 = static_cast<uint32_t>(crc64);
+  while (length > 0) {
+    crc32 = _mm_crc32_u8(crc32, *data);
+    data++;
+    length--;
+  }
+  return crc32;
+}
+#endif
+
+uint32_t update(uint32_t crc, const uint8_t* data, std::size_t length) {
+#ifdef COMPC_CRC32C_SSE42
+  static const bool sse42 = __builtin_cpu_supports("sse4.2");
+  if (sse42) {
+    return update_sse42(crc, data, length);
+  }
+#endif
+  return update_portable(crc, data, length);
+}
+
+} // namespace
+
+bool compc::crc32c_hardware_accelerated() {
+#ifdef COMPC_CRC32C_SSE42
+  return __builtin_cpu_supports("sse4.2");
+#else
+  return false;
+#endif
+}
+
+uint32_t compc::crc32c(const uint8_t* data, std::size_t length, uint32_t crc) {
+  return ~update(~crc, data, length);
+}
+
+uint32_t compc::crc32c_portable(const uint8_t* data, std::size_t length, uint32_t crc) {
+  return ~update_portable(~crc, data, length);
+}
+
+uint32_t compc::crc32c_bits(const uint8_t* data, std::size_t start_bit, std::size_t end_bit, bool lsb_first) {
+  if (end_bit <= start_bit) {
+    return 0;
+  }
+  std::size_t first_byte = start_bit / 8;
+  std::size_t last_byte = (end_bit - 1) / 8;
+  uint8_t first = 0;
+  uint8_t last = 0;
+#pragma omp atomic read
+  first = data[first_byte];
+#pragma omp atomic read
+  last = data[last_byte];
+  auto first_mask = static_cast<uint8_t>(0xFFU >> (start_bit % 8));
+  auto last_mask = static_cast<uint8_t>(0xFFU << ((8 - end_bit % 8) % 8));
+  if (lsb_first) {
+    first_mask = static_cast<uint8_t>(0xFFU << (start_bit % 8));
+    last_mask = static_cast<uint8_t>(0xFFU >> ((8 - end_bit % 8) % 8));
+  }
+  uint32_t crc = ~uint32_t{0};
+  if (first_byte == last_byte) {
+    uint8_t only = first & first_mask & last_mask;
+    return ~update(crc, &only, 1);
+  }
+  first &= first_mask;
+  last &= last_mask;
+  crc = update(crc, &first, 1);
+  crc = update(crc, data + first_byte + 1, last_byte - first_byte - 1);
+  crc = update(crc, &last, 1);
+  return ~crc;
+}
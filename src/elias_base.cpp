@@ -0,0 +1,832 @@
+#include "compintc/elias_base.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "compintc/crc32c.hpp"
+#include "compintc/stats.hpp"
+#include "compintc/thread_budget.hpp"
+
+template <typename T> std::size_t compc::EliasBase<T>::get_compressed_length(const T* array, std::size_t length) {
+  compc::ArrayPrefixSummary prefix_tuple = get_prefix_sum_array(array, length);
+  return prefix_tuple.local_sums[prefix_tuple.total_chunks - 1];
+}
+
+template <typename T>
+compc::ArrayPrefixSummary compc::EliasBase<T>::get_prefix_sum_array(const T* array, std::size_t length) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  int local_threads = this->threads();
+  uint32_t batch_size = this->batch_size_small;
+  // inefficient for lenght close this
+  if (length < static_cast<std::size_t>(batch_size) * static_cast<std::size_t>(local_threads)) {
+    local_threads = static_cast<int>((length + batch_size - 1) / batch_size);
+  } else if (length >= 2 * this->batch_size_large * static_cast<uint32_t>(this->threads())) {
+    batch_size = this->batch_size_large;
+  }
+  std::size_t total_chunks = (length + batch_size - 1) / batch_size;
+  std::vector<std::size_t> local_sums(total_chunks);
+
+  bool error = false;
+  // bits of the chunks of every thread, turned into the offset of its first chunk
+  std::vector<std::size_t> thread_sums(static_cast<std::size_t>(std::max(local_threads, 1)) + 1, 0);
+
+// every thread sizes a contiguous range of chunks, the prefix sum is a parallel scan over the ranges
+#pragma omp parallel default(none) shared(local_sums, error, array, thread_sums)                                       \
+    firstprivate(batch_size, length, total_chunks) num_threads(local_threads)
+  {
+    bool error_local = false;
+    auto thread_num = static_cast<std::size_t>(omp_get_thread_num());
+    auto num_threads_local = static_cast<std::size_t>(omp_get_num_threads());
+    std::size_t first_chunk = total_chunks * thread_num / num_threads_local;
+    std::size_t last_chunk = total_chunks * (thread_num + 1) / num_threads_local;
+    std::size_t running_sum = 0;
+    for (std::size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+      std::size_t start = chunk * batch_size;
+      std::size_t end = std::min(start + batch_size, length);
+      running_sum += this->chunk_bit_length(array, start, end, error_local);
+      local_sums[chunk] = running_sum;
+    }
+    thread_sums[thread_num + 1] = running_sum;
+#pragma omp atomic
+    error |= error_local;
+#pragma omp barrier
+#pragma omp single
+    for (std::size_t t = 1; t <= num_threads_local; t++) {
+      thread_sums[t] += thread_sums[t - 1];
+    }
+    for (std::size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+      local_sums[chunk] += thread_sums[thread_num];
+    }
+  }
+  return compc::ArrayPrefixSummary{local_threads, batch_size, local_sums, total_chunks,
+                                   error}; // this should use elision
+}
+
+template <typename T>
+void compc::EliasBase<T>::encode_chunks(const T* array, std::size_t length, const ArrayPrefixSummary& prefix_tuple,
+                                        uint8_t* compressed, const EncodeHooks& hooks) {
+  int local_threads = prefix_tuple.local_threads;
+  const std::vector<std::size_t>& prefix_array = prefix_tuple.local_sums;
+  uint32_t batch_size = prefix_tuple.batch_size;
+  std::size_t total_chunks = prefix_tuple.total_chunks;
+  uint32_t* chunk_checksums = hooks.chunk_checksums;
+  const bool track_progress = hooks.on_final_prefix || hooks.final_prefix_bytes != nullptr;
+  const bool lsb_first = this->bit_order == BitOrder::lsb_first;
+  // chunks that are encoded, and the first chunk that is not
+  std::vector<uint8_t> done(track_progress ? total_chunks : 0, 0);
+  std::size_t frontier = 0;
+  std::vector<std::size_t>* chunks_per_thread = nullptr;
+  if (this->stats != nullptr) {
+    this->stats->chunks_per_thread.assign(static_cast<std::size_t>(local_threads), 0);
+    chunks_per_thread = &this->stats->chunks_per_thread;
+  }
+
+  // contiguous ranges of chunks with an equal share of the output bits, chunks of large values cost more to encode
+  std::vector<std::size_t> first_chunks(static_cast<std::size_t>(local_threads) + 1, total_chunks);
+  const auto prefix_end = prefix_array.begin() + static_cast<std::ptrdiff_t>(total_chunks);
+  const std::size_t total_bits = total_chunks == 0 ? 0 : prefix_array[total_chunks - 1];
+  for (std::size_t t = 1; t < static_cast<std::size_t>(local_threads); t++) {
+    std::size_t share = total_bits * t / static_cast<std::size_t>(local_threads);
+    first_chunks[t] = static_cast<std::size_t>(std::upper_bound(prefix_array.begin(), prefix_end, share) -
+                                               prefix_array.begin());
+  }
+  first_chunks[0] = 0;
+
+  auto encode_round = [&](std::size_t round) {
+    std::size_t start_bit = round == 0 ? 0 : prefix_array[round - 1];
+    std::size_t start_index = round * static_cast<std::size_t>(batch_size);
+    std::size_t end_bit = prefix_array[round];
+    std::size_t end_index = std::min(start_index + batch_size, length);
+    this->encode_chunk(array, start_index, end_index, start_bit, end_bit, compressed);
+    if (chunk_checksums != nullptr) {
+      chunk_checksums[round] = compc::crc32c_bits(compressed, start_bit, end_bit, lsb_first);
+    }
+    if (track_progress) {
+#pragma omp critical(compc_final_prefix)
+      {
+        done[round] = 1;
+        std::size_t previous_frontier = frontier;
+        while (frontier < total_chunks && done[frontier] != 0) {
+          frontier++;
+        }
+        if (frontier != previous_frontier) {
+          std::size_t final_bytes =
+              frontier == total_chunks ? (prefix_array[total_chunks - 1] + 7) / 8 : prefix_array[frontier - 1] / 8;
+          if (hooks.final_prefix_bytes != nullptr) {
+            hooks.final_prefix_bytes->store(final_bytes, std::memory_order_release);
+          }
+          if (hooks.on_final_prefix) {
+            hooks.on_final_prefix(compressed, final_bytes);
+          }
+        }
+      }
+    }
+  };
+
+#pragma omp parallel default(none) shared(encode_round, chunks_per_thread, first_chunks)                               \
+    firstprivate(total_chunks, track_progress) num_threads(local_threads)
+  {
+    std::size_t local_chunks = 0;
+    auto thread_num = static_cast<std::size_t>(omp_get_thread_num());
+    auto num_threads_local = static_cast<std::size_t>(omp_get_num_threads());
+    if (track_progress) {
+      // chunks are taken in order, so the final prefix grows while the others are encoded
+#pragma omp for schedule(dynamic, 1)
+      for (std::size_t round = 0; round < total_chunks; round++) {
+        encode_round(round);
+        local_chunks++;
+      }
+    } else {
+      // a smaller team than requested takes over the ranges of the missing threads
+      for (std::size_t range = thread_num; range + 1 < first_chunks.size(); range += num_threads_local) {
+        for (std::size_t round = first_chunks[range]; round < first_chunks[range + 1]; round++) {
+          encode_round(round);
+          local_chunks++;
+        }
+      }
+    }
+    if (chunks_per_thread != nullptr) {
+      (*chunks_per_thread)[thread_num] = local_chunks;
+    }
+  }
+}
+
+template <typename T>
+bool compc::EliasBase<T>::decode_chunks(const uint8_t* array, std::size_t binary_length,
+                                        const std::vector<std::size_t>& chunk_end_bits, uint32_t batch_size,
+                                        T* output, std::size_t array_length, const uint32_t* chunk_checksums,
+                                        std::vector<std::size_t>* corrupt_chunks) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  std::size_t total_chunks = chunk_end_bits.size();
+  const bool lsb_first = this->bit_order == BitOrder::lsb_first;
+  int local_threads = this->threads();
+  if (total_chunks < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(total_chunks), 1);
+  }
+  std::vector<std::size_t> corrupt{};
+#pragma omp parallel for schedule(dynamic, 1) default(none)                                                            \
+    shared(array, chunk_end_bits, output, chunk_checksums, corrupt)                                                    \
+    firstprivate(binary_length, batch_size, array_length, total_chunks, lsb_first) num_threads(local_threads)
+  for (std::size_t round = 0; round < total_chunks; round++) {
+    std::size_t start_bit = (round == 0) ? 0 : chunk_end_bits[round - 1];
+    if (chunk_checksums != nullptr &&
+        compc::crc32c_bits(array, start_bit, chunk_end_bits[round], lsb_first) != chunk_checksums[round]) {
+#pragma omp critical
+      corrupt.push_back(round);
+      continue;
+    }
+    std::size_t start_index = round * batch_size;
+    std::size_t count = std::min(static_cast<std::size_t>(batch_size), array_length - start_index);
+    this->decode_chunk(array, binary_length, start_bit, output + start_index, count);
+  }
+  std::sort(corrupt.begin(), corrupt.end());
+  if (corrupt_chunks != nullptr) {
+    corrupt_chunks->insert(corrupt_chunks->end(), corrupt.begin(), corrupt.end());
+  }
+  return corrupt.empty();
+}
+
+namespace {
+/*
+  ORs the first bits of source into destination starting at start_bit, the first and the last byte can be shared.
+  With lsb_first the streams use BitOrder::lsb_first, and the bits move towards the high end of a byte.
+*/
+void or_bits_at(const uint8_t* source, std::size_t bits, uint8_t* destination, std::size_t start_bit,
+                bool lsb_first) {
+  if (bits == 0) {
+    return;
+  }
+  const std::size_t first_byte = start_bit / 8;
+  const std::size_t last_byte = (start_bit + bits - 1) / 8;
+  const std::size_t source_bytes = (bits + 7) / 8;
+  const auto shift = static_cast<uint32_t>(start_bit % 8);
+  // byte j of the destination, taken from the source bytes j - first_byte - 1 and j - first_byte
+  auto shifted = [&](std::size_t j) {
+    std::size_t i = j - first_byte;
+    uint32_t current = i < source_bytes ? static_cast<uint32_t>(source[i]) : 0U;
+    uint32_t previous = (shift != 0 && i > 0) ? static_cast<uint32_t>(source[i - 1]) : 0U;
+    uint32_t value = lsb_first ? (current << shift) | (previous >> (8U - shift))
+                               : (current >> shift) | (previous << (8U - shift));
+    return static_cast<uint8_t>(value & 255U);
+  };
+  uint8_t first = shifted(first_byte);
+#pragma omp atomic
+  destination[first_byte] |= first;
+  if (last_byte == first_byte) {
+    return;
+  }
+  if (shift == 0) {
+    std::memcpy(destination + first_byte + 1, source + 1, last_byte - first_byte - 1);
+  } else {
+    for (std::size_t j = first_byte + 1; j < last_byte; j++) {
+      destination[j] = shifted(j);
+    }
+  }
+  uint8_t last = shifted(last_byte);
+#pragma omp atomic
+  destination[last_byte] |= last;
+}
+} // namespace
+
+template <typename T>
+std::unique_ptr<uint8_t[]> compc::EliasBase<T>::encode_single_pass(const T* array, std::size_t length,
+                                                                   std::size_t& compressed_bytes) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  const std::size_t batch_size = this->batch_size_large;
+  const std::size_t total_chunks = (length + batch_size - 1) / batch_size;
+  int local_threads = this->threads();
+  if (total_chunks < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(total_chunks), 1);
+  }
+  std::vector<std::vector<uint8_t>> scratch(static_cast<std::size_t>(local_threads));
+  // bit offset of the output of every thread, the last entry is the total
+  std::vector<std::size_t> thread_bits(static_cast<std::size_t>(local_threads) + 1, 0);
+  std::unique_ptr<uint8_t[]> compressed = nullptr;
+  bool error = false;
+  const bool lsb_first = this->bit_order == BitOrder::lsb_first;
+
+#pragma omp parallel default(none) shared(array, scratch, thread_bits, compressed, error)                              \
+    firstprivate(length, batch_size, total_chunks, lsb_first) num_threads(local_threads)
+  {
+    auto thread_num = static_cast<std::size_t>(omp_get_thread_num());
+    auto num_threads_local = static_cast<std::size_t>(omp_get_num_threads());
+    // contiguous ranges of chunks, so the scratch buffers only have to be concatenated
+    std::size_t first_chunk = total_chunks * thread_num / num_threads_local;
+    std::size_t last_chunk = total_chunks * (thread_num + 1) / num_threads_local;
+    std::vector<uint8_t>& local = scratch[thread_num];
+    local.reserve((last_chunk - first_chunk) * batch_size * sizeof(T));
+    std::size_t bits = 0;
+    bool error_local = false;
+    for (std::size_t chunk = first_chunk; chunk < last_chunk; chunk++) {
+      std::size_t start_index = chunk * batch_size;
+      std::size_t end_index = std::min(start_index + batch_size, length);
+      std::size_t chunk_bits = this->chunk_bit_length(array, start_index, end_index, error_local);
+      if (error_local) {
+        break;
+      }
+      local.resize((bits + chunk_bits + 7) / 8, 0);
+      this->encode_chunk(array, start_index, end_index, bits, bits + chunk_bits, local.data());
+      bits += chunk_bits;
+    }
+    thread_bits[thread_num + 1] = bits;
+#pragma omp atomic
+    error |= error_local;
+#pragma omp barrier
+#pragma omp single
+    {
+      for (std::size_t t = 1; t < thread_bits.size(); t++) {
+        thread_bits[t] += thread_bits[t - 1];
+      }
+      if (!error) {
+        // zero initialize, the bytes between two threads are combined with an or
+        compressed = std::make_unique<uint8_t[]>((thread_bits.back() + 7) / 8);
+      }
+    }
+    if (compressed != nullptr) {
+      or_bits_at(local.data(), thread_bits[thread_num + 1] - thread_bits[thread_num], compressed.get(),
+                 thread_bits[thread_num], lsb_first);
+    }
+  }
+  compressed_bytes = (thread_bits.back() + 7) / 8;
+  if (this->stats != nullptr) {
+    this->stats->total_chunks = total_chunks;
+    this->stats->batch_size = static_cast<uint32_t>(batch_size);
+    this->stats->threads_used = local_threads;
+  }
+  return compressed;
+}
+
+namespace {
+// values transformed at a time by the small message path, kept on the stack
+constexpr std::size_t small_block_size = 256;
+
+// the serial counterpart of transform_array_inputs for a single number, revert_transforms undoes it
+template <typename T> T transformed_input(T value, T offset, bool map_negative_numbers) {
+  if (map_negative_numbers) {
+    T bi = (value < 0);
+    value = static_cast<T>(static_cast<T>(value * (2 - 4 * bi)) - bi);
+  }
+  return static_cast<T>(value + offset);
+}
+
+// passes the numbers of array to block(values, count) in blocks with the transforms applied, stops if it returns false
+template <typename T, typename Block>
+void for_each_small_block(const T* array, std::size_t length, T offset, bool map_negative_numbers, Block&& block) {
+  if (offset == 0 && !map_negative_numbers) {
+    block(array, length);
+    return;
+  }
+  T values[small_block_size];
+  for (std::size_t start = 0; start < length; start += small_block_size) {
+    std::size_t count = std::min(small_block_size, length - start);
+    for (std::size_t i = 0; i < count; i++) {
+      values[i] = transformed_input(array[start + i], offset, map_negative_numbers);
+    }
+    if (!block(static_cast<const T*>(values), count)) {
+      return;
+    }
+  }
+}
+} // namespace
+
+template <typename T>
+std::size_t compc::EliasBase<T>::compress_small(const T* input_array, std::size_t size, uint8_t* output,
+                                                std::size_t output_bytes) {
+  std::size_t bits = 0;
+  bool error = false;
+  for_each_small_block(input_array, size, this->offset, this->map_negative_numbers,
+                       [&](const T* values, std::size_t count) {
+                         bits = this->encode_values(values, count, output, output_bytes, bits, error);
+                         return !error;
+                       });
+  return error ? 0 : (bits + 7) / 8;
+}
+
+template <typename T>
+void compc::EliasBase<T>::decompress_small(const uint8_t* array, std::size_t binary_length, T* output,
+                                           std::size_t array_length) {
+  this->decode_chunk(array, binary_length, 0, output, array_length);
+  if (this->offset != 0 || this->map_negative_numbers) {
+    for (std::size_t i = 0; i < array_length; i++) {
+      output[i] = compc::revert_transforms(output[i], this->offset, this->map_negative_numbers);
+    }
+  }
+}
+
+template <typename T>
+std::unique_ptr<uint8_t[]> compc::EliasBase<T>::compress(const T* input_array, std::size_t& size) {
+  if (this->stats != nullptr) {
+    this->stats->reset();
+  }
+  compc::PhaseTimer timer(this->stats);
+  const uint64_t N = size;
+  if (N < this->small_message_threshold && !this->single_pass && !this->on_final_prefix &&
+      this->final_prefix_bytes == nullptr) {
+    std::size_t compressed_length = 0;
+    bool error = false;
+    for_each_small_block(input_array, N, this->offset, this->map_negative_numbers,
+                         [&](const T* values, std::size_t count) {
+                           compressed_length += this->chunk_bit_length(values, 0, count, error);
+                           return !error;
+                         });
+    if (error) {
+      return nullptr;
+    }
+    const std::size_t compressed_bytes = (compressed_length + 7) / 8;
+    // every byte is written by the bit writer
+    std::unique_ptr<uint8_t[]> compressed(new uint8_t[compressed_bytes]);
+    if (this->compress_small(input_array, N, compressed.get(), compressed_bytes) != compressed_bytes) {
+      return nullptr;
+    }
+    timer.lap(&CompressionStats::encode_ns);
+    if (this->stats != nullptr) {
+      this->stats->total_chunks = 1;
+      this->stats->batch_size = static_cast<uint32_t>(N);
+      this->stats->threads_used = 1;
+      this->stats->bits_per_value = N == 0 ? 0.0 : static_cast<double>(compressed_length) / static_cast<double>(N);
+    }
+    size = compressed_bytes;
+    return compressed;
+  }
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  const T* array = nullptr;
+  std::unique_ptr<T[]> heap_copy_array; // TODO change to make_unique_for_overwrite
+  if (this->map_negative_numbers || this->offset != 0) {
+    heap_copy_array = this->transform_array_inputs(input_array, size);
+    array = heap_copy_array.get();
+  } else {
+    array = input_array;
+  }
+  timer.lap(&CompressionStats::transform_ns);
+  if (this->single_pass) {
+    std::size_t compressed_bytes = 0;
+    std::unique_ptr<uint8_t[]> compressed = this->encode_single_pass(array, N, compressed_bytes);
+    timer.lap(&CompressionStats::encode_ns);
+    if (compressed != nullptr) {
+      if (this->stats != nullptr) {
+        this->stats->bits_per_value =
+            N == 0 ? 0.0 : static_cast<double>(compressed_bytes * 8) / static_cast<double>(N);
+      }
+      size = compressed_bytes;
+    }
+    return compressed;
+  }
+  ArrayPrefixSummary prefix_tuple = this->get_prefix_sum_array(array, N); // in bits
+  timer.lap(&CompressionStats::sizing_ns);
+  if (prefix_tuple.error) {
+    return nullptr;
+  }
+
+  const uint64_t compressed_length = prefix_tuple.local_sums[prefix_tuple.total_chunks - 1];
+  const uint64_t compressed_bytes = (compressed_length + 7) / 8; // getting the number of bytes (ceil)
+  // zero initialize, otherwise there are problems at the edges of the batches
+  std::unique_ptr<uint8_t[]> compressed = std::make_unique<uint8_t[]>(compressed_bytes);
+  timer.lap(&CompressionStats::allocation_ns);
+
+  compc::EncodeHooks hooks;
+  hooks.on_final_prefix = this->on_final_prefix;
+  hooks.final_prefix_bytes = this->final_prefix_bytes;
+  this->encode_chunks(array, N, prefix_tuple, compressed.get(), hooks);
+  timer.lap(&CompressionStats::encode_ns);
+  if (this->stats != nullptr) {
+    this->stats->total_chunks = prefix_tuple.total_chunks;
+    this->stats->batch_size = prefix_tuple.batch_size;
+    this->stats->threads_used = prefix_tuple.local_threads;
+    this->stats->bits_per_value = N == 0 ? 0.0 : static_cast<double>(compressed_length) / static_cast<double>(N);
+  }
+  size = compressed_bytes;
+  return compressed;
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::EliasBase<T>::decompress(const uint8_t* array, std::size_t binary_length,
+                                                     std::size_t array_length) {
+  if (this->stats != nullptr) {
+    this->stats->reset();
+  }
+  compc::PhaseTimer timer(this->stats);
+  std::unique_ptr<T[]> uncomp(new T[array_length]);
+  if (array_length < this->small_message_threshold) {
+    this->decompress_small(array, binary_length, uncomp.get(), array_length);
+    timer.lap(&CompressionStats::decode_ns);
+  } else {
+    compc::ThreadLease lease(this->thread_budget, this->num_threads);
+    this->decode(array, binary_length, uncomp.get(), array_length);
+    timer.lap(&CompressionStats::decode_ns);
+    this->transform_array_outputs(uncomp.get(), array_length);
+    timer.lap(&CompressionStats::post_transform_ns);
+  }
+  if (this->stats != nullptr) {
+    this->stats->threads_used = 1; // the decoder is serial
+    this->stats->bits_per_value =
+        array_length == 0 ? 0.0 : static_cast<double>(binary_length * 8) / static_cast<double>(array_length);
+  }
+  return uncomp;
+}
+
+namespace {
+// number of value starts recorded at the beginning of every speculative range
+constexpr std::size_t speculation_window = 256;
+// ranges shorter than this are not worth a thread
+constexpr std::size_t min_speculative_bytes = 1U << 12U;
+
+template <typename T> struct SpeculativeRange {
+  std::vector<T> values{};
+  std::vector<std::size_t> starts{};
+  std::size_t end_bit = 0;
+};
+} // namespace
+
+template <typename T>
+std::unique_ptr<T[]> compc::EliasBase<T>::decompress_speculative(const uint8_t* array, std::size_t binary_length,
+                                                                 std::size_t array_length) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  int local_threads = this->threads();
+  if (binary_length / min_speculative_bytes < static_cast<std::size_t>(local_threads)) {
+    local_threads = static_cast<int>(binary_length / min_speculative_bytes);
+  }
+  if (local_threads <= 1) {
+    return this->decompress(array, binary_length, array_length);
+  }
+  if (this->stats != nullptr) {
+    this->stats->reset();
+  }
+  compc::PhaseTimer timer(this->stats);
+  const auto ranges = static_cast<std::size_t>(local_threads);
+  const std::size_t total_bits = binary_length * 8;
+  std::vector<SpeculativeRange<T>> speculative(ranges);
+
+#pragma omp parallel for schedule(static, 1) default(none) shared(array, speculative)                                  \
+    firstprivate(binary_length, array_length, ranges, total_bits) num_threads(local_threads)
+  for (std::size_t k = 0; k < ranges; k++) {
+    SpeculativeRange<T>& range = speculative[k];
+    range.values.reserve(array_length / ranges + 1);
+    range.end_bit = this->decode_range(array, binary_length, total_bits * k / ranges, total_bits * (k + 1) / ranges,
+                                       range.values, range.starts, speculation_window);
+  }
+
+  // the first range starts at a value, every other one is repaired from the true end of its predecessor
+  for (std::size_t k = 1; k < ranges; k++) {
+    SpeculativeRange<T>& range = speculative[k];
+    const std::vector<std::size_t>& starts = range.starts;
+    const std::size_t true_start = speculative[k - 1].end_bit;
+    auto in_sync = std::lower_bound(starts.begin(), starts.end(), true_start);
+    if (in_sync != starts.end() && *in_sync == true_start) {
+      range.values.erase(range.values.begin(), range.values.begin() + (in_sync - starts.begin()));
+      continue;
+    }
+    // decodes from the true start until a value starts where one of the speculative decode started
+    std::vector<T> repaired;
+    std::vector<std::size_t> repaired_starts;
+    std::size_t bit = true_start;
+    if (!starts.empty() && true_start < starts.back()) {
+      bit = this->decode_range(array, binary_length, true_start, starts.back() + 1, repaired, repaired_starts,
+                               repaired_starts.max_size());
+      std::size_t i = 0;
+      std::size_t j = 0;
+      while (i < repaired_starts.size() && j < starts.size() && repaired_starts[i] != starts[j]) {
+        if (repaired_starts[i] < starts[j]) {
+          i++;
+        } else {
+          j++;
+        }
+      }
+      if (i < repaired_starts.size() && j < starts.size()) {
+        repaired.resize(i);
+        repaired.insert(repaired.end(), range.values.begin() + static_cast<std::ptrdiff_t>(j), range.values.end());
+        range.values.swap(repaired);
+        continue;
+      }
+    }
+    // never got into sync within the window, the rest of the range is decoded again
+    range.end_bit = this->decode_range(array, binary_length, bit, total_bits * (k + 1) / ranges, repaired,
+                                       repaired_starts, 0);
+    range.values.swap(repaired);
+  }
+  timer.lap(&CompressionStats::decode_ns);
+
+  std::vector<std::size_t> value_offsets(ranges + 1, 0);
+  for (std::size_t k = 0; k < ranges; k++) {
+    value_offsets[k + 1] = value_offsets[k] + speculative[k].values.size();
+  }
+  std::unique_ptr<T[]> uncomp(new T[array_length]);
+  T* uncomp_ptr = uncomp.get();
+#pragma omp parallel for schedule(static, 1) default(none) shared(speculative, value_offsets, uncomp_ptr)              \
+    firstprivate(ranges, array_length) num_threads(local_threads)
+  for (std::size_t k = 0; k < ranges; k++) {
+    // the padding at the end of the stream can decode to extra values
+    if (value_offsets[k] < array_length) {
+      std::size_t count = std::min(speculative[k].values.size(), array_length - value_offsets[k]);
+      std::memcpy(static_cast<void*>(uncomp_ptr + value_offsets[k]),
+                  static_cast<const void*>(speculative[k].values.data()), count * sizeof(T));
+    }
+  }
+  if (value_offsets[ranges] < array_length) {
+    // malformed input, too few values
+    std::fill(uncomp_ptr + value_offsets[ranges], uncomp_ptr + array_length, T{0});
+  }
+  this->transform_array_outputs(uncomp_ptr, array_length);
+  timer.lap(&CompressionStats::post_transform_ns);
+  if (this->stats != nullptr) {
+    this->stats->threads_used = local_threads;
+    this->stats->bits_per_value =
+        array_length == 0 ? 0.0 : static_cast<double>(binary_length * 8) / static_cast<double>(array_length);
+  }
+  return uncomp;
+}
+
+namespace {
+struct BatchChunk {
+  std::size_t array;
+  std::size_t start_index;
+  std::size_t end_index;
+  std::size_t start_bit;
+  std::size_t end_bit;
+};
+} // namespace
+
+template <typename T>
+compc::CompressedBatch compc::EliasBase<T>::compress_batch(const std::vector<const T*>& arrays,
+                                                           const std::vector<std::size_t>& lengths) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  if (this->stats != nullptr) {
+    this->stats->reset();
+  }
+  compc::PhaseTimer timer(this->stats);
+  const std::size_t number_of_arrays = arrays.size();
+  std::vector<std::size_t> value_offsets(number_of_arrays + 1, 0);
+  for (std::size_t a = 0; a < number_of_arrays; a++) {
+    value_offsets[a + 1] = value_offsets[a] + lengths[a];
+  }
+  const std::size_t total_values = value_offsets[number_of_arrays];
+
+  // all arrays are transformed in one concatenated copy
+  std::vector<const T*> sources = arrays;
+  std::unique_ptr<T[]> heap_copy_array;
+  if (this->map_negative_numbers || this->offset != 0) {
+    heap_copy_array = std::unique_ptr<T[]>(new T[std::max<std::size_t>(total_values, 1)]);
+    for (std::size_t a = 0; a < number_of_arrays; a++) {
+      std::memcpy(static_cast<void*>(heap_copy_array.get() + value_offsets[a]), static_cast<const void*>(arrays[a]),
+                  lengths[a] * sizeof(T));
+      sources[a] = heap_copy_array.get() + value_offsets[a];
+    }
+    if (this->map_negative_numbers) {
+      this->transform_to_natural_numbers(heap_copy_array.get(), total_values);
+    }
+    if (this->offset != 0) {
+      this->add_offset(heap_copy_array.get(), total_values, this->offset);
+    }
+  }
+  timer.lap(&CompressionStats::transform_ns);
+
+  // global work list over the chunks of all arrays
+  int local_threads = this->threads();
+  std::vector<BatchChunk> chunks;
+  for (std::size_t a = 0; a < number_of_arrays; a++) {
+    std::size_t batch_size = this->batch_size_small;
+    std::size_t large_threshold =
+        2 * static_cast<std::size_t>(this->batch_size_large) * static_cast<std::size_t>(local_threads);
+    if (lengths[a] >= large_threshold) {
+      batch_size = this->batch_size_large;
+    }
+    for (std::size_t start = 0; start < lengths[a]; start += batch_size) {
+      chunks.push_back(BatchChunk{a, start, std::min(start + batch_size, lengths[a]), 0, 0});
+    }
+  }
+  const std::size_t total_chunks = chunks.size();
+  if (total_chunks < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(total_chunks), 1);
+  }
+
+  bool error = false;
+#pragma omp parallel for schedule(dynamic, 4) default(none) shared(chunks, sources) reduction(|| : error)              \
+    firstprivate(total_chunks) num_threads(local_threads)
+  for (std::size_t c = 0; c < total_chunks; c++) {
+    BatchChunk& chunk = chunks[c];
+    bool error_local = false;
+    chunk.end_bit = this->chunk_bit_length(sources[chunk.array], chunk.start_index, chunk.end_index, error_local);
+    error = error || error_local;
+  }
+  timer.lap(&CompressionStats::sizing_ns);
+  if (error) {
+    return compc::CompressedBatch{};
+  }
+
+  // bit offsets relative to the start of each array, every array starts at a new byte
+  std::vector<std::size_t> array_bits(number_of_arrays, 0);
+  for (BatchChunk& chunk : chunks) {
+    std::size_t& bits = array_bits[chunk.array];
+    chunk.start_bit = bits;
+    bits += chunk.end_bit;
+    chunk.end_bit = bits;
+  }
+  std::vector<std::size_t> byte_offsets(number_of_arrays + 1, 0);
+  for (std::size_t a = 0; a < number_of_arrays; a++) {
+    byte_offsets[a + 1] = byte_offsets[a] + (array_bits[a] + 7) / 8;
+  }
+  const std::size_t compressed_bytes = byte_offsets[number_of_arrays];
+  // zero initialize, otherwise there are problems at the edges of the batches
+  std::unique_ptr<uint8_t[]> compressed = std::make_unique<uint8_t[]>(std::max<std::size_t>(compressed_bytes, 1));
+  timer.lap(&CompressionStats::allocation_ns);
+
+  uint8_t* compressed_ptr = compressed.get();
+#pragma omp parallel for schedule(dynamic, 4) default(none) shared(chunks, sources, byte_offsets, compressed_ptr)      \
+    firstprivate(total_chunks) num_threads(local_threads)
+  for (std::size_t c = 0; c < total_chunks; c++) {
+    const BatchChunk& chunk = chunks[c];
+    this->encode_chunk(sources[chunk.array], chunk.start_index, chunk.end_index, chunk.start_bit, chunk.end_bit,
+                       compressed_ptr + byte_offsets[chunk.array]);
+  }
+  timer.lap(&CompressionStats::encode_ns);
+  if (this->stats != nullptr) {
+    this->stats->total_chunks = total_chunks;
+    this->stats->threads_used = local_threads;
+    this->stats->bits_per_value =
+        static_cast<double>(compressed_bytes * 8) / static_cast<double>(std::max<std::size_t>(total_values, 1));
+  }
+  return compc::CompressedBatch{std::move(compressed), std::move(byte_offsets), lengths};
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::EliasBase<T>::decompress_batch(const uint8_t* data,
+                                                           const std::vector<std::size_t>& byte_offsets,
+                                                           const std::vector<std::size_t>& lengths) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  if (this->stats != nullptr) {
+    this->stats->reset();
+  }
+  compc::PhaseTimer timer(this->stats);
+  const std::size_t number_of_arrays = lengths.size();
+  std::vector<std::size_t> value_offsets(number_of_arrays + 1, 0);
+  for (std::size_t a = 0; a < number_of_arrays; a++) {
+    value_offsets[a + 1] = value_offsets[a] + lengths[a];
+  }
+  const std::size_t total_values = value_offsets[number_of_arrays];
+  std::unique_ptr<T[]> uncomp(new T[std::max<std::size_t>(total_values, 1)]);
+  int local_threads = this->threads();
+  if (number_of_arrays < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(number_of_arrays), 1);
+  }
+  T* output = uncomp.get();
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(data, byte_offsets, lengths, value_offsets, output) \
+    firstprivate(number_of_arrays) num_threads(local_threads)
+  for (std::size_t a = 0; a < number_of_arrays; a++) {
+    if (lengths[a] > 0) {
+      this->decode(data + byte_offsets[a], byte_offsets[a + 1] - byte_offsets[a], output + value_offsets[a],
+                   lengths[a]);
+    }
+  }
+  timer.lap(&CompressionStats::decode_ns);
+  this->transform_array_outputs(output, total_values);
+  timer.lap(&CompressionStats::post_transform_ns);
+  if (this->stats != nullptr) {
+    this->stats->threads_used = local_threads;
+    this->stats->bits_per_value = static_cast<double>(byte_offsets[number_of_arrays] * 8) /
+                                  static_cast<double>(std::max<std::size_t>(total_values, 1));
+  }
+  return uncomp;
+}
+
+template <typename T> std::unique_ptr<T[]> compc::EliasBase<T>::decompress_batch(const CompressedBatch& batch) {
+  return this->decompress_batch(batch.data.get(), batch.byte_offsets, batch.lengths);
+}
+
+template <typename T>
+compc::SegmentedOutput compc::EliasBase<T>::compress_segments(const T* input_array, std::size_t size,
+                                                              std::size_t chunks_per_segment) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  constexpr std::size_t cache_line = 64;
+  if (size == 0) {
+    return compc::SegmentedOutput{std::make_unique<uint8_t[]>(1), {}};
+  }
+  const T* array = input_array;
+  std::unique_ptr<T[]> heap_copy_array;
+  if (this->map_negative_numbers || this->offset != 0) {
+    heap_copy_array = this->transform_array_inputs(input_array, size);
+    array = heap_copy_array.get();
+  }
+  ArrayPrefixSummary prefix_tuple = this->get_prefix_sum_array(array, size);
+  if (prefix_tuple.error) {
+    return compc::SegmentedOutput{};
+  }
+  const std::vector<std::size_t>& prefix_array = prefix_tuple.local_sums;
+  const std::size_t total_chunks = prefix_tuple.total_chunks;
+  const std::size_t batch_size = prefix_tuple.batch_size;
+  chunks_per_segment = std::max<std::size_t>(chunks_per_segment, 1);
+  const std::size_t number_of_segments = (total_chunks + chunks_per_segment - 1) / chunks_per_segment;
+
+  // every segment starts at a cache line of the storage
+  std::vector<std::size_t> storage_offsets(number_of_segments + 1, 0);
+  std::vector<std::size_t> first_bits(number_of_segments, 0);
+  for (std::size_t s = 0; s < number_of_segments; s++) {
+    std::size_t last_chunk = std::min((s + 1) * chunks_per_segment, total_chunks) - 1;
+    first_bits[s] = s == 0 ? 0 : prefix_array[s * chunks_per_segment - 1];
+    std::size_t bytes = (prefix_array[last_chunk] - first_bits[s] + 7) / 8;
+    storage_offsets[s + 1] = storage_offsets[s] + (bytes + cache_line - 1) / cache_line * cache_line;
+  }
+  compc::SegmentedOutput output;
+  // zero initialize, otherwise there are problems at the edges of the batches
+  output.storage = std::make_unique<uint8_t[]>(storage_offsets[number_of_segments] + cache_line);
+  auto misalignment = reinterpret_cast<std::uintptr_t>(output.storage.get()) % cache_line;
+  uint8_t* base = output.storage.get() + (misalignment == 0 ? 0 : cache_line - misalignment);
+  output.segments.resize(number_of_segments);
+  std::vector<compc::Segment>& segments = output.segments;
+
+  int local_threads = prefix_tuple.local_threads;
+  if (number_of_segments < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(number_of_segments), 1);
+  }
+#pragma omp parallel for schedule(dynamic, 1) default(none)                                                            \
+    shared(array, prefix_array, storage_offsets, first_bits, segments, base)                                           \
+    firstprivate(size, total_chunks, batch_size, chunks_per_segment, number_of_segments) num_threads(local_threads)
+  for (std::size_t s = 0; s < number_of_segments; s++) {
+    uint8_t* segment = base + storage_offsets[s];
+    std::size_t first_chunk = s * chunks_per_segment;
+    std::size_t end_chunk = std::min(first_chunk + chunks_per_segment, total_chunks);
+    for (std::size_t c = first_chunk; c < end_chunk; c++) {
+      std::size_t start_bit = (c == 0 ? 0 : prefix_array[c - 1]) - first_bits[s];
+      std::size_t end_index = std::min((c + 1) * batch_size, size);
+      this->encode_chunk(array, c * batch_size, end_index, start_bit, prefix_array[c] - first_bits[s], segment);
+    }
+    std::size_t end_index = std::min(end_chunk * batch_size, size);
+    segments[s] = compc::Segment{segment, (prefix_array[end_chunk - 1] - first_bits[s] + 7) / 8,
+                                 end_index - first_chunk * batch_size};
+  }
+  return output;
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::EliasBase<T>::decompress_segments(const std::vector<Segment>& segments) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  const std::size_t number_of_segments = segments.size();
+  std::vector<std::size_t> value_offsets(number_of_segments + 1, 0);
+  for (std::size_t s = 0; s < number_of_segments; s++) {
+    value_offsets[s + 1] = value_offsets[s] + segments[s].values;
+  }
+  const std::size_t array_length = value_offsets[number_of_segments];
+  std::unique_ptr<T[]> uncomp(new T[std::max<std::size_t>(array_length, 1)]);
+  T* output = uncomp.get();
+  int local_threads = this->threads();
+  if (number_of_segments < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(number_of_segments), 1);
+  }
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(segments, value_offsets, output)                    \
+    firstprivate(number_of_segments) num_threads(local_threads)
+  for (std::size_t s = 0; s < number_of_segments; s++) {
+    this->decode_chunk(segments[s].data, segments[s].size, 0, output + value_offsets[s], segments[s].values);
+  }
+  this->transform_array_outputs(output, array_length);
+  return uncomp;
+}
+
+template class compc::EliasBase<int16_t>;
+template class compc::EliasBase<uint16_t>;
+template class compc::EliasBase<int32_t>;
+template class compc::EliasBase<uint32_t>;
+template class compc::EliasBase<int64_t>;
+template class compc::EliasBase<uint64_t>;
@@ -0,0 +1,627 @@
+#ifndef COMPC_ELIAS_KERNELS_H_
+#define COMPC_ELIAS_KERNELS_H_
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/helpers.hpp"
+
+/*
+  Value level kernels of the three codecs on top of a buffered bit reader and writer.
+  They read the same MSB-first bit stream the encode_chunk loops produce, but
+  can start at any bit offset, which is what the chunk parallel decoders need.
+  The LSB-first readers and writers produce the layout of BitOrder::lsb_first.
+*/
+namespace compc::kernels {
+
+class MsbBitReader {
+public:
+  MsbBitReader(const uint8_t* data, std::size_t length_bytes, std::size_t start_bit)
+      : array(data), length(length_bytes), next_byte(start_bit / 8) {
+    refill();
+    consume(static_cast<uint32_t>(start_bit % 8));
+  }
+
+  // position of the next unread bit
+  std::size_t position() const { return next_byte * 8 - available; }
+
+  // reads up to 64 bits as an unsigned number
+  uint64_t read(uint32_t bits) {
+    if (bits > 56) {
+      while (bits > 64) { // malformed input, only the low 64 bits are kept
+        uint32_t skipped = std::min(bits - 64, 32U);
+        read(skipped);
+        bits -= skipped;
+      }
+      uint32_t low_bits = bits - 32;
+      uint64_t high = read(32);
+      return (high << low_bits) | read(low_bits);
+    }
+    if (bits == 0) {
+      return 0;
+    }
+    if (available < bits) {
+      refill();
+    }
+    uint64_t value = window >> (64U - bits);
+    consume(bits);
+    return value;
+  }
+
+  bool read_bit() { return read(1) != 0; }
+
+  // returns the next 1 to 56 bits without consuming them
+  uint64_t peek(uint32_t bits) {
+    if (available < bits) {
+      refill();
+    }
+    return window >> (64U - bits);
+  }
+
+  // reads a 1 followed by bits more bits, returns the number they form
+  uint64_t read_leading_one(uint32_t bits) { return read(bits + 1); }
+
+  // consumes the zeros before the next 1 bit and returns their number, the 1 is not consumed
+  uint32_t count_zeros() {
+    uint32_t zeros = 0;
+    while (true) {
+      if (available < 57) {
+        refill();
+      }
+      if (window != 0) {
+        auto leading = static_cast<uint32_t>(__builtin_clzll(window));
+        consume(leading);
+        return zeros + leading;
+      }
+      zeros += available;
+      consume(available);
+      if (next_byte >= length + 8) {
+        return zeros; // malformed input, ran out of bits
+      }
+    }
+  }
+
+private:
+  const uint8_t* array;
+  std::size_t length;
+  std::size_t next_byte;
+  uint64_t window{0}; // unread bits, left aligned
+  uint32_t available{0};
+
+  // bytes past the end of the array are read as zeros
+  void refill() {
+    while (available <= 56) {
+      uint64_t byte = (next_byte < length) ? array[next_byte] : 0U;
+      window |= byte << (56U - available);
+      available += 8;
+      next_byte++;
+    }
+  }
+
+  void consume(uint32_t bits) {
+    window = (bits == 64) ? 0 : window << bits;
+    available -= bits;
+  }
+};
+
+/*
+  Reads one lane of an interleaved layout, where the lanes are split into
+  32 bit words and word k of lane l is stored at word k * lanes + l. Every
+  word holds its bits MSB-first, like the bytes of a plain stream.
+*/
+class LaneBitReader {
+public:
+  LaneBitReader(const uint8_t* words, std::size_t words_per_lane, std::size_t lanes, std::size_t lane)
+      : array(words + lane * 4), length(words_per_lane), stride(lanes * 4) {}
+
+  // reads up to 64 bits as an unsigned number
+  uint64_t read(uint32_t bits) {
+    while (bits > 64) { // malformed input, only the low 64 bits are kept
+      uint32_t skipped = std::min(bits - 64, 32U);
+      read(skipped);
+      bits -= skipped;
+    }
+    if (bits > 32) {
+      uint32_t low_bits = bits - 32;
+      uint64_t high = read(32);
+      return (high << low_bits) | read(low_bits);
+    }
+    if (bits == 0) {
+      return 0;
+    }
+    if (available < bits) {
+      refill();
+    }
+    uint64_t value = window >> (64U - bits);
+    consume(bits);
+    return value;
+  }
+
+  bool read_bit() { return read(1) != 0; }
+
+  // reads a 1 followed by bits more bits, returns the number they form
+  uint64_t read_leading_one(uint32_t bits) { return read(bits + 1); }
+
+  // consumes the zeros before the next 1 bit and returns their number, the 1 is not consumed
+  uint32_t count_zeros() {
+    uint32_t zeros = 0;
+    while (true) {
+      if (available <= 32) {
+        refill();
+      }
+      if (window != 0) {
+        auto leading = static_cast<uint32_t>(__builtin_clzll(window));
+        consume(leading);
+        return zeros + leading;
+      }
+      zeros += available;
+      consume(available);
+      if (next_word >= length + 2) {
+        return zeros; // malformed input, ran out of bits
+      }
+    }
+  }
+
+private:
+  const uint8_t* array;
+  std::size_t length;
+  std::size_t stride;
+  std::size_t next_word{0};
+  uint64_t window{0}; // unread bits, left aligned
+  uint32_t available{0};
+
+  // words past the end of the lane are read as zeros
+  void refill() {
+    while (available <= 32) {
+      uint64_t word = 0;
+      if (next_word < length) {
+        const uint8_t* bytes = array + next_word * stride;
+        word = (uint64_t{bytes[0]} << 24U) | (uint64_t{bytes[1]} << 16U) | (uint64_t{bytes[2]} << 8U) | bytes[3];
+      }
+      window |= word << (32U - available);
+      available += 32;
+      next_word++;
+    }
+  }
+
+  void consume(uint32_t bits) {
+    window = (bits == 64) ? 0 : window << bits;
+    available -= bits;
+  }
+};
+
+/*
+  Writes an MSB-first bit stream through a 64 bit window, whole bytes are
+  stored with plain writes, so the output does not have to be zeroed. The
+  bits before start_bit are kept. Bytes at or past length_bytes are never
+  written, overflowed() tells whether the stream did not fit.
+*/
+class MsbBitWriter {
+public:
+  MsbBitWriter(uint8_t* data, std::size_t length_bytes, std::size_t start_bit)
+      : array(data), length(length_bytes), next_byte(start_bit / 8), pending(static_cast<uint32_t>(start_bit % 8)) {
+    if (pending != 0) {
+      window = (next_byte < length) ? uint64_t{array[next_byte]} >> (8U - pending) << (64U - pending) : 0U;
+    }
+  }
+
+  // position of the next bit to write
+  std::size_t position() const { return next_byte * 8 + pending; }
+
+  bool overflowed() const { return overflow; }
+
+  // writes the low bits of value, up to 64
+  void write(uint64_t value, uint32_t bits) {
+    if (bits > 32) {
+      write(value >> 32U, bits - 32);
+      bits = 32;
+    }
+    if (bits == 0) {
+      return;
+    }
+    value &= (uint64_t{1} << bits) - 1;
+    window |= value << (64U - pending - bits);
+    pending += bits;
+    if (pending >= 32) {
+      store(4);
+    }
+  }
+
+  void write_zeros(uint32_t bits) {
+    while (bits > 32) {
+      write(0, 32);
+      bits -= 32;
+    }
+    write(0, bits);
+  }
+
+  // writes a 1 followed by the low bits of value, value has its leading 1 at position bits
+  void write_leading_one(uint64_t value, uint32_t bits) { write(value, bits + 1); }
+
+  // stores the pending bits, the unused low bits of the last byte are zero, returns the bit after the last one
+  std::size_t finish() {
+    std::size_t end_bit = position();
+    store((pending + 7) / 8);
+    return end_bit;
+  }
+
+private:
+  uint8_t* array;
+  std::size_t length;
+  std::size_t next_byte;
+  uint32_t pending;   // bits in the window
+  uint64_t window{0}; // bits not yet stored, left aligned
+  bool overflow{false};
+
+  void store(uint32_t bytes) {
+    for (uint32_t b = 0; b < bytes; b++) {
+      if (next_byte < length) {
+        array[next_byte] = static_cast<uint8_t>(window >> 56U);
+      } else {
+        overflow = true;
+      }
+      next_byte++;
+      window <<= 8U;
+    }
+    pending = (pending >= bytes * 8) ? pending - bytes * 8 : 0;
+  }
+};
+
+/*
+  Reads the LSB-first layout: bit k of the stream is bit k % 8 of byte k / 8,
+  and the bits of a number are stored starting with its least significant one.
+  Every read loads the 8 bytes at the current position as one little endian
+  word, so the zeros of a prefix are counted with a single trailing zero count
+  and there is no window to refill.
+*/
+class LsbBitReader {
+public:
+  LsbBitReader(const uint8_t* data, std::size_t length_bytes, std::size_t start_bit)
+      : array(data), length(length_bytes), bit(start_bit) {}
+
+  // position of the next unread bit
+  std::size_t position() const { return bit; }
+
+  // reads up to 64 bits as an unsigned number
+  uint64_t read(uint32_t bits) {
+    if (bits > 56) {
+      while (bits > 64) { // malformed input, only the high 64 bits are kept
+        uint32_t skipped = std::min(bits - 64, 32U);
+        bit += skipped;
+        bits -= skipped;
+      }
+      uint64_t low = read(32);
+      return low | (read(bits - 32) << 32U);
+    }
+    uint64_t value = peek() & ((uint64_t{1} << bits) - 1);
+    bit += bits;
+    return value;
+  }
+
+  bool read_bit() {
+    std::size_t byte = bit / 8;
+    bool set = byte < length && ((array[byte] >> (bit % 8)) & 1U) != 0;
+    bit++;
+    return set;
+  }
+
+  // reads a 1 followed by bits more bits, returns the number they form with the 1 as its leading bit
+  uint64_t read_leading_one(uint32_t bits) {
+    bit++;
+    uint64_t leading = (bits < 64) ? uint64_t{1} << bits : 0U;
+    return leading | read(bits);
+  }
+
+  // consumes the zeros before the next 1 bit and returns their number, the 1 is not consumed
+  uint32_t count_zeros() {
+    uint32_t zeros = 0;
+    while (true) {
+      uint64_t word = peek();
+      if (word != 0) {
+        auto trailing = static_cast<uint32_t>(__builtin_ctzll(word));
+        bit += trailing;
+        return zeros + trailing;
+      }
+      auto loaded = static_cast<uint32_t>(64 - bit % 8);
+      zeros += loaded;
+      bit += loaded;
+      if (bit / 8 >= length + 8) {
+        return zeros; // malformed input, ran out of bits
+      }
+    }
+  }
+
+private:
+  const uint8_t* array;
+  std::size_t length;
+  std::size_t bit;
+
+  // the next 57 to 64 bits in the low bits, bytes past the end of the array are read as zeros
+  uint64_t peek() const {
+    std::size_t byte = bit / 8;
+    uint64_t word = 0;
+    if (byte + 8 <= length) {
+      word = hlprs::load_le<uint64_t>(array + byte);
+    } else {
+      for (std::size_t i = 0; byte + i < length && i < 8; i++) {
+        word |= uint64_t{array[byte + i]} << (8 * i);
+      }
+    }
+    return word >> (bit % 8);
+  }
+};
+
+/*
+  Writes the LSB-first layout a 32 bit word at a time. Like MsbBitWriter, the
+  bits before start_bit are kept and bytes at or past length_bytes are never
+  written. With shared_edges the output has to be zeroed, and the first byte,
+  if the stream does not start at a byte boundary, and the last partial byte
+  are or-ed in atomically, so neighbouring chunks can be written concurrently.
+*/
+class LsbBitWriter {
+public:
+  LsbBitWriter(uint8_t* data, std::size_t length_bytes, std::size_t start_bit, bool shared_edges = false)
+      : array(data), length(length_bytes), next_byte(start_bit / 8), pending(static_cast<uint32_t>(start_bit % 8)),
+        shared(shared_edges), shared_first(shared_edges && pending != 0) {
+    if (pending != 0 && !shared && next_byte < length) {
+      window = array[next_byte] & ((1U << pending) - 1U);
+    }
+  }
+
+  // position of the next bit to write
+  std::size_t position() const { return next_byte * 8 + pending; }
+
+  bool overflowed() const { return overflow; }
+
+  // writes the low bits of value, up to 64
+  void write(uint64_t value, uint32_t bits) {
+    if (bits > 32) {
+      write(value, 32);
+      value >>= 32U;
+      bits -= 32;
+    }
+    if (bits == 0) {
+      return;
+    }
+    value &= (uint64_t{1} << bits) - 1;
+    window |= value << pending;
+    pending += bits;
+    if (pending >= 32) {
+      store_word();
+    }
+  }
+
+  void write_zeros(uint32_t bits) {
+    while (bits > 32) {
+      write(0, 32);
+      bits -= 32;
+    }
+    write(0, bits);
+  }
+
+  // writes a 1 followed by the low bits of value, value has its leading 1 at position bits
+  void write_leading_one(uint64_t value, uint32_t bits) { write((value << 1U) | 1U, bits + 1); }
+
+  // stores the pending bits, the unused high bits of the last byte are zero, returns the bit after the last one
+  std::size_t finish() {
+    std::size_t end_bit = position();
+    while (pending > 0) {
+      store_byte(pending < 8 && shared);
+    }
+    return end_bit;
+  }
+
+private:
+  uint8_t* array;
+  std::size_t length;
+  std::size_t next_byte;
+  uint32_t pending;   // bits in the window
+  uint64_t window{0}; // bits not yet stored, the next one in the lowest bit
+  bool shared;
+  bool shared_first; // the first byte holds bits of the previous chunk
+  bool overflow{false};
+
+  void store_word() {
+    if (!shared_first && next_byte + 4 <= length) {
+      hlprs::store_le<uint32_t>(array + next_byte, static_cast<uint32_t>(window));
+      next_byte += 4;
+      window >>= 32U;
+      pending -= 32;
+      return;
+    }
+    for (int b = 0; b < 4; b++) {
+      store_byte(false);
+    }
+  }
+
+  void store_byte(bool shared_last) {
+    auto byte = static_cast<uint8_t>(window & 255U);
+    if (next_byte >= length) {
+      overflow = true;
+    } else if (shared_first || shared_last) {
+#pragma omp atomic
+      array[next_byte] |= byte;
+    } else {
+      array[next_byte] = byte;
+    }
+    shared_first = false;
+    next_byte++;
+    window >>= 8U;
+    pending = (pending >= 8) ? pending - 8 : 0;
+  }
+};
+
+template <typename T> struct Gamma {
+  static std::size_t bits(T value) {
+    return (static_cast<std::size_t>(hlprs::log2(static_cast<unsigned long long>(value))) << 1U) + 1;
+  }
+  template <typename Writer> static void write(Writer& writer, T value) {
+    auto N = static_cast<uint32_t>(hlprs::log2(static_cast<unsigned long long>(value)));
+    writer.write_zeros(N);
+    writer.write_leading_one(static_cast<uint64_t>(value), N);
+  }
+  template <typename Reader> static T read(Reader& reader) {
+    uint32_t length_prefix_part = reader.count_zeros();
+    return static_cast<T>(reader.read_leading_one(length_prefix_part));
+  }
+};
+
+template <typename T> struct Delta {
+  static std::size_t bits(T value) {
+    auto N = static_cast<std::size_t>(hlprs::log2(static_cast<unsigned long long>(value)));
+    auto L = static_cast<std::size_t>(hlprs::log2(static_cast<unsigned long long>(N + 1)));
+    return (L << 1U) + 1 + N;
+  }
+  template <typename Writer> static void write(Writer& writer, T value) {
+    auto N = static_cast<uint32_t>(hlprs::log2(static_cast<unsigned long long>(value)));
+    auto L = static_cast<uint32_t>(hlprs::log2(static_cast<unsigned long long>(N + 1)));
+    writer.write_zeros(L);
+    writer.write_leading_one(N + 1, L);
+    // the leading 1 is implied
+    writer.write(static_cast<uint64_t>(value), N);
+  }
+  template <typename Reader> static T read(Reader& reader) {
+    uint32_t length_prefix_part = reader.count_zeros();
+    auto N = static_cast<uint32_t>(reader.read_leading_one(length_prefix_part) - 1);
+    if (N > 63) {
+      return 0; // malformed input
+    }
+    // inserting the implied leading 1
+    return static_cast<T>((uint64_t{1} << N) | reader.read(N));
+  }
+};
+
+template <typename T> struct Omega {
+  static std::size_t bits(T value) {
+    std::size_t length = 1;
+    int N = hlprs::log2(static_cast<unsigned long long>(value));
+    while (N >= 1) {
+      length += static_cast<std::size_t>(N + 1);
+      N = hlprs::log2(static_cast<unsigned long long>(N));
+    }
+    return length;
+  }
+  template <typename Writer> static void write(Writer& writer, T value) {
+    // the groups from the value down to the length of the shortest one, written in reverse
+    uint64_t groups[8];
+    uint32_t count = 0;
+    auto N = static_cast<uint64_t>(value);
+    while (N > 1) {
+      groups[count++] = N;
+      N = static_cast<uint64_t>(hlprs::log2(static_cast<unsigned long long>(N)));
+    }
+    while (count > 0) {
+      count--;
+      auto group_bits = static_cast<uint32_t>(hlprs::log2(static_cast<unsigned long long>(groups[count])));
+      writer.write_leading_one(groups[count], group_bits);
+    }
+    writer.write(0, 1);
+  }
+  template <typename Reader> static T read(Reader& reader) {
+    uint64_t N = 1;
+    while (reader.read_bit()) {
+      auto group_bits = static_cast<uint32_t>(N);
+      if (group_bits > 63) {
+        return 0; // malformed input
+      }
+      N = (uint64_t{1} << group_bits) | reader.read(group_bits);
+    }
+    return static_cast<T>(N);
+  }
+};
+
+// encodes count values at start_bit, sets error if a value cannot be encoded or the output does not fit
+template <typename Kernel, typename T, typename Writer = MsbBitWriter>
+std::size_t encode_values(const T* values, std::size_t count, uint8_t* output, std::size_t output_bytes,
+                          std::size_t start_bit, bool& error) {
+  Writer writer(output, output_bytes, start_bit);
+  for (std::size_t i = 0; i < count; i++) {
+    if (!values[i]) {
+      error = true; // zero has no code
+      break;
+    }
+    Kernel::write(writer, values[i]);
+  }
+  std::size_t end_bit = writer.finish();
+  error |= writer.overflowed();
+  return end_bit;
+}
+
+// decodes count values starting at start_bit, returns the bit position after the last value
+template <typename Kernel, typename T, typename Reader = MsbBitReader>
+std::size_t decode_values(const uint8_t* array, std::size_t binary_length, std::size_t start_bit, T* output,
+                          std::size_t count) {
+  Reader reader(array, binary_length, start_bit);
+  for (std::size_t i = 0; i < count; i++) {
+    output[i] = Kernel::read(reader);
+  }
+  return reader.position();
+}
+
+// appends the values starting before end_bit to output, and the start bits of the first max_starts of them to starts
+template <typename Kernel, typename T, typename Reader = MsbBitReader>
+std::size_t decode_range(const uint8_t* array, std::size_t binary_length, std::size_t start_bit, std::size_t end_bit,
+                         std::vector<T>& output, std::vector<std::size_t>& starts, std::size_t max_starts) {
+  Reader reader(array, binary_length, start_bit);
+  std::size_t position = start_bit;
+  std::size_t recorded = 0;
+  while (position < end_bit) {
+    if (recorded < max_starts) {
+      starts.push_back(position);
+      recorded++;
+    }
+    output.push_back(Kernel::read(reader));
+    position = reader.position();
+  }
+  return position;
+}
+
+/*
+  The same for a codec whose layout is chosen at runtime. The MSB-first
+  encode_chunk stays codec specific, lsb_first chunks are written here into
+  the bits [start_bit, end_bit) of the zero initialized output.
+*/
+template <typename Kernel, typename T>
+void encode_chunk_lsb(const T* array, std::size_t start_index, std::size_t end_index, std::size_t start_bit,
+                      std::size_t end_bit, uint8_t* output) {
+  LsbBitWriter writer(output, (end_bit + 7) / 8, start_bit, true);
+  for (std::size_t i = start_index; i < end_index; i++) {
+    Kernel::write(writer, array[i]);
+  }
+  writer.finish();
+}
+
+template <typename Kernel, typename T>
+std::size_t encode_values(BitOrder order, const T* values, std::size_t count, uint8_t* output,
+                          std::size_t output_bytes, std::size_t start_bit, bool& error) {
+  if (order == BitOrder::lsb_first) {
+    return encode_values<Kernel, T, LsbBitWriter>(values, count, output, output_bytes, start_bit, error);
+  }
+  return encode_values<Kernel, T, MsbBitWriter>(values, count, output, output_bytes, start_bit, error);
+}
+
+template <typename Kernel, typename T>
+std::size_t decode_values(BitOrder order, const uint8_t* array, std::size_t binary_length, std::size_t start_bit,
+                          T* output, std::size_t count) {
+  if (order == BitOrder::lsb_first) {
+    return decode_values<Kernel, T, LsbBitReader>(array, binary_length, start_bit, output, count);
+  }
+  return decode_values<Kernel, T, MsbBitReader>(array, binary_length, start_bit, output, count);
+}
+
+template <typename Kernel, typename T>
+std::size_t decode_range(BitOrder order, const uint8_t* array, std::size_t binary_length, std::size_t start_bit,
+                         std::size_t end_bit, std::vector<T>& output, std::vector<std::size_t>& starts,
+                         std::size_t max_starts) {
+  if (order == BitOrder::lsb_first) {
+    return decode_range<Kernel, T, LsbBitReader>(array, binary_length, start_bit, end_bit, output, starts,
+                                                 max_starts);
+  }
+  return decode_range<Kernel, T, MsbBitReader>(array, binary_length, start_bit, end_bit, output, starts, max_starts);
+}
+
+} // namespace compc::kernels
+
+#endif // COMPC_ELIAS_KERNELS_H_
@@ -0,0 +1,131 @@
+#ifndef COMPC_ELIAS_LANES_H_
+#define COMPC_ELIAS_LANES_H_
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/helpers.hpp"
+#include "elias_kernels.hpp"
+
+/*
+  Interleaved multi-lane layout shared by the codecs that offer it. Value i
+  is encoded in lane i % lanes, and every lane is a plain stream of its own.
+
+  Layout, the integers little endian:
+    uint32 lanes
+    uint32 words_per_lane
+    words_per_lane * lanes 32 bit words, word k of lane l at index k * lanes + l
+  Lanes shorter than the longest one are padded with zero words.
+*/
+namespace compc::lanes {
+
+constexpr std::size_t header_bytes = 2 * sizeof(uint32_t);
+
+inline bool valid_lane_count(uint32_t lanes) { return lanes == 4 || lanes == 8 || lanes == 16; }
+
+/*
+  Returns a nullptr if the number of lanes is not supported, a number cannot be encoded or a lane is too long for the
+  32 bit words_per_lane of the header. The lanes are encoded with encode_chunk, so the codec has to write the
+  MSB-first order LaneBitReader expects.
+*/
+template <typename T>
+std::unique_ptr<uint8_t[]> encode(EliasBase<T>& codec, const T* input_array, std::size_t& size, uint32_t lanes) {
+  if (!valid_lane_count(lanes) || codec.bit_order != BitOrder::msb_first) {
+    return nullptr;
+  }
+  ThreadLease lease(codec.thread_budget, codec.num_threads);
+  const std::size_t length = size;
+  std::unique_ptr<T[]> heap_copy_array = codec.transform_array_inputs(input_array, size);
+  const T* array = heap_copy_array != nullptr ? heap_copy_array.get() : input_array;
+  // the lanes are gathered and encoded separately, each into a whole number of words
+  std::vector<std::vector<uint8_t>> encoded(lanes);
+  std::vector<std::size_t> lane_bits(lanes, 0);
+  int local_threads = std::min(codec.threads(), static_cast<int>(lanes));
+  bool error = false;
+#pragma omp parallel for schedule(static, 1) default(none) shared(codec, array, encoded, lane_bits)                    \
+    reduction(|| : error) firstprivate(length, lanes) num_threads(local_threads)
+  for (std::size_t l = 0; l < lanes; l++) {
+    std::vector<T> values;
+    values.reserve(length / lanes + 1);
+    for (std::size_t i = l; i < length; i += lanes) {
+      values.push_back(array[i]);
+    }
+    bool error_local = false;
+    std::size_t bits = codec.chunk_bit_length(values.data(), 0, values.size(), error_local);
+    if (error_local) {
+      error = true;
+      continue;
+    }
+    encoded[l].assign((bits + 31) / 32 * 4, 0);
+    if (!values.empty()) {
+      codec.encode_chunk(values.data(), 0, values.size(), 0, bits, encoded[l].data());
+    }
+    lane_bits[l] = bits;
+  }
+  if (error) {
+    return nullptr;
+  }
+  const std::size_t words_per_lane = (*std::max_element(lane_bits.begin(), lane_bits.end()) + 31) / 32;
+  if (words_per_lane > std::numeric_limits<uint32_t>::max()) {
+    return nullptr;
+  }
+  const std::size_t compressed_bytes = header_bytes + words_per_lane * lanes * 4;
+  // zero initialize, the padding words of the shorter lanes are not written
+  std::unique_ptr<uint8_t[]> compressed = std::make_unique<uint8_t[]>(compressed_bytes);
+  hlprs::store_le<uint32_t>(compressed.get(), lanes);
+  hlprs::store_le<uint32_t>(compressed.get() + sizeof(uint32_t), static_cast<uint32_t>(words_per_lane));
+  uint8_t* words = compressed.get() + header_bytes;
+  for (std::size_t l = 0; l < lanes; l++) {
+    for (std::size_t k = 0; k < encoded[l].size() / 4; k++) {
+      std::memcpy(words + (k * lanes + l) * 4, encoded[l].data() + k * 4, 4);
+    }
+  }
+  size = compressed_bytes;
+  return compressed;
+}
+
+/*
+  Decodes the lanes round-robin. The lanes do not depend on each other, so
+  the reads of different lanes can overlap in the pipeline. Returns a nullptr
+  if the layout is malformed.
+*/
+template <typename Kernel, typename T>
+std::unique_ptr<T[]> decode(EliasBase<T>& codec, const uint8_t* array, std::size_t binary_length,
+                            std::size_t array_length) {
+  if (binary_length < header_bytes) {
+    return nullptr;
+  }
+  const uint32_t lanes = hlprs::load_le<uint32_t>(array);
+  const std::size_t words_per_lane = hlprs::load_le<uint32_t>(array + sizeof(uint32_t));
+  if (!valid_lane_count(lanes) || header_bytes + words_per_lane * lanes * 4 > binary_length) {
+    return nullptr;
+  }
+  std::vector<kernels::LaneBitReader> readers;
+  readers.reserve(lanes);
+  for (std::size_t l = 0; l < lanes; l++) {
+    readers.emplace_back(array + header_bytes, words_per_lane, lanes, l);
+  }
+  std::unique_ptr<T[]> uncomp(new T[array_length]);
+  T* output = uncomp.get();
+  std::size_t i = 0;
+  for (; i + lanes <= array_length; i += lanes) {
+    for (std::size_t l = 0; l < lanes; l++) {
+      output[i + l] = Kernel::read(readers[l]);
+    }
+  }
+  for (std::size_t l = 0; i < array_length; i++, l++) {
+    output[i] = Kernel::read(readers[l]);
+  }
+  codec.transform_array_outputs(output, array_length);
+  return uncomp;
+}
+
+} // namespace compc::lanes
+
+#endif // COMPC_ELIAS_LANES_H_
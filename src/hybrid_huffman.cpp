@@ -0,0 +1,364 @@
+#include "compintc/hybrid_huffman.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "compintc/helpers.hpp"
+#include "compintc/thread_budget.hpp"
+#include "elias_kernels.hpp"
+
+namespace {
+// N = floor(log2(v)) of a 64 bit value
+constexpr uint32_t length_symbols = 64;
+// width of the smallest and the largest N and of the code lengths in a block header
+constexpr uint32_t table_field_bits = 6;
+// codes up to this length are decoded with a single table lookup
+constexpr uint32_t max_lookup_bits = 10;
+
+// canonical Huffman code of the N of one block
+struct LengthCode {
+  uint32_t min_symbol = 0;
+  uint32_t max_symbol = 0;
+  std::array<uint8_t, length_symbols> lengths{};
+  std::array<uint64_t, length_symbols> codes{};
+  std::size_t bits = 0; // size of the encoded block
+};
+
+// Huffman code lengths of the used symbols, ties are broken by the order of the nodes so the code is deterministic
+void huffman_lengths(const std::array<std::size_t, length_symbols>& histogram,
+                     std::array<uint8_t, length_symbols>& lengths) {
+  struct Node {
+    int left;
+    int right;
+    uint32_t symbol;
+  };
+  using Entry = std::pair<std::size_t, std::size_t>; // weight, node
+  std::vector<Node> nodes;
+  std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+  for (uint32_t s = 0; s < length_symbols; s++) {
+    if (histogram[s] > 0) {
+      queue.emplace(histogram[s], nodes.size());
+      nodes.push_back(Node{-1, -1, s});
+    }
+  }
+  if (nodes.size() == 1) {
+    return; // a single symbol needs no code
+  }
+  while (queue.size() > 1) {
+    Entry a = queue.top();
+    queue.pop();
+    Entry b = queue.top();
+    queue.pop();
+    queue.emplace(a.first + b.first, nodes.size());
+    nodes.push_back(Node{static_cast<int>(a.second), static_cast<int>(b.second), 0});
+  }
+  // children are created before their parents, so the depths can be set from the root down
+  std::vector<uint8_t> depth(nodes.size(), 0);
+  for (std::size_t i = nodes.size(); i-- > 0;) {
+    if (nodes[i].left >= 0) {
+      depth[static_cast<std::size_t>(nodes[i].left)] = static_cast<uint8_t>(depth[i] + 1);
+      depth[static_cast<std::size_t>(nodes[i].right)] = static_cast<uint8_t>(depth[i] + 1);
+    } else {
+      lengths[nodes[i].symbol] = depth[i];
+    }
+  }
+}
+
+// canonical codes, ordered by length and then by symbol
+void assign_codes(LengthCode& code) {
+  uint64_t next = 0;
+  for (uint32_t length = 1; length < length_symbols; length++) {
+    for (uint32_t s = code.min_symbol; s <= code.max_symbol; s++) {
+      if (code.lengths[s] == length) {
+        code.codes[s] = next++;
+      }
+    }
+    next <<= 1U;
+  }
+}
+
+template <typename T> uint32_t length_symbol(T value) {
+  return static_cast<uint32_t>(hlprs::log2(static_cast<unsigned long long>(value)));
+}
+
+template <typename T> uint64_t mantissa(T value, uint32_t symbol) {
+  auto bits = static_cast<uint64_t>(static_cast<unsigned long long>(value));
+  return symbol == 0 ? 0 : bits & (~uint64_t{0} >> (64U - symbol));
+}
+
+// builds the code of array[start, end) and sizes the block, returns false if a number cannot be encoded
+template <typename T> bool plan_block(const T* array, std::size_t start, std::size_t end, LengthCode& code) {
+  std::array<std::size_t, length_symbols> histogram{};
+  for (std::size_t i = start; i < end; i++) {
+    if (!array[i]) {
+      return false;
+    }
+    histogram[length_symbol(array[i])]++;
+  }
+  code.min_symbol = length_symbols - 1;
+  code.max_symbol = 0;
+  for (uint32_t s = 0; s < length_symbols; s++) {
+    if (histogram[s] > 0) {
+      code.min_symbol = std::min(code.min_symbol, s);
+      code.max_symbol = std::max(code.max_symbol, s);
+    }
+  }
+  huffman_lengths(histogram, code.lengths);
+  assign_codes(code);
+  code.bits = table_field_bits * (2 + code.max_symbol - code.min_symbol + 1);
+  for (uint32_t s = code.min_symbol; s <= code.max_symbol; s++) {
+    code.bits += histogram[s] * (code.lengths[s] + s);
+  }
+  return true;
+}
+
+template <typename T> void encode_block(const T* array, std::size_t start, std::size_t end, const LengthCode& code,
+                                        uint8_t* out) {
+  compc::kernels::MsbBitWriter writer(out, (code.bits + 7) / 8, 0);
+  writer.write(code.min_symbol, table_field_bits);
+  writer.write(code.max_symbol, table_field_bits);
+  for (uint32_t s = code.min_symbol; s <= code.max_symbol; s++) {
+    writer.write(code.lengths[s], table_field_bits);
+  }
+  for (std::size_t i = start; i < end; i++) {
+    uint32_t symbol = length_symbol(array[i]);
+    writer.write(code.codes[symbol], code.lengths[symbol]);
+    writer.write(mantissa(array[i], symbol), symbol);
+  }
+  writer.finish();
+}
+
+// returns false if the block is malformed
+template <typename T> bool decode_block(const uint8_t* block, std::size_t bytes, T* output, std::size_t count) {
+  compc::kernels::MsbBitReader reader(block, bytes, 0);
+  auto min_symbol = static_cast<uint32_t>(reader.read(table_field_bits));
+  auto max_symbol = static_cast<uint32_t>(reader.read(table_field_bits));
+  if (min_symbol > max_symbol) {
+    return false;
+  }
+  // canonical decoding tables: the first code of every length and the symbols ordered by their codes
+  std::array<uint8_t, length_symbols> lengths{};
+  std::array<uint64_t, length_symbols> first_code{};
+  std::array<uint32_t, length_symbols> codes_of_length{};
+  std::array<uint32_t, length_symbols> first_index{};
+  std::vector<uint32_t> sorted_symbols;
+  uint32_t max_length = 0;
+  for (uint32_t s = min_symbol; s <= max_symbol; s++) {
+    lengths[s] = static_cast<uint8_t>(reader.read(table_field_bits));
+    if (lengths[s] > 0) {
+      codes_of_length[lengths[s]]++;
+      max_length = std::max<uint32_t>(max_length, lengths[s]);
+    }
+  }
+  uint64_t next = 0;
+  for (uint32_t length = 1; length < length_symbols; length++) {
+    first_code[length] = next;
+    first_index[length] = static_cast<uint32_t>(sorted_symbols.size());
+    for (uint32_t s = min_symbol; s <= max_symbol; s++) {
+      if (lengths[s] == length) {
+        sorted_symbols.push_back(s);
+      }
+    }
+    next = (next + codes_of_length[length]) << 1U;
+  }
+  const bool single_symbol = sorted_symbols.empty();
+  // the symbol and the length of every code up to lookup_bits long, indexed by the next lookup_bits bits
+  const uint32_t lookup_bits = std::min(max_length, max_lookup_bits);
+  std::array<uint16_t, std::size_t{1} << max_lookup_bits> lookup{}; // length << 8 | symbol, 0 for longer codes
+  for (uint32_t length = 1; length <= lookup_bits; length++) {
+    for (uint32_t j = 0; j < codes_of_length[length]; j++) {
+      std::size_t first = (first_code[length] + j) << (lookup_bits - length);
+      if (first >= (std::size_t{1} << lookup_bits)) {
+        return false; // more codes than fit into the length
+      }
+      auto entry = static_cast<uint16_t>(length << 8U | sorted_symbols[first_index[length] + j]);
+      std::fill_n(lookup.begin() + static_cast<std::ptrdiff_t>(first), std::size_t{1} << (lookup_bits - length), entry);
+    }
+  }
+  for (std::size_t i = 0; i < count; i++) {
+    uint32_t symbol = min_symbol;
+    if (!single_symbol) {
+      uint16_t entry = lookup[reader.peek(lookup_bits)];
+      if (entry != 0) {
+        symbol = entry & 0xFFU;
+        reader.read(entry >> 8U);
+      } else {
+        // longer than the table, continue with the canonical decode after the first lookup_bits bits
+        uint32_t length = lookup_bits;
+        uint64_t code = reader.read(lookup_bits);
+        // unused prefixes of a length are larger than its codes, and the difference wraps around for smaller ones
+        do {
+          if (length >= max_length) {
+            return false;
+          }
+          code = (code << 1U) | reader.read(1);
+          length++;
+        } while (code - first_code[length] >= codes_of_length[length]);
+        symbol = sorted_symbols[first_index[length] + code - first_code[length]];
+      }
+    }
+    output[i] = static_cast<T>((uint64_t{1} << symbol) | reader.read(symbol));
+  }
+  return reader.position() <= bytes * 8;
+}
+
+int threads_for(int num_threads, std::size_t work_items) {
+  if (work_items < static_cast<std::size_t>(num_threads)) {
+    return std::max(static_cast<int>(work_items), 1);
+  }
+  return num_threads;
+}
+
+// the codes of all blocks, returns false if a number cannot be encoded
+template <typename T>
+bool plan_blocks(const T* array, std::size_t length, std::size_t block_size, int num_threads,
+                 std::vector<LengthCode>& codes) {
+  const std::size_t blocks = (length + block_size - 1) / block_size;
+  codes.resize(blocks);
+  int local_threads = threads_for(num_threads, blocks);
+  bool error = false;
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(array, codes) reduction(|| : error)                 \
+    firstprivate(length, block_size, blocks) num_threads(local_threads)
+  for (std::size_t b = 0; b < blocks; b++) {
+    error = error || !plan_block(array, b * block_size, std::min((b + 1) * block_size, length), codes[b]);
+  }
+  return !error;
+}
+
+std::size_t stream_header_bytes(std::size_t blocks) { return sizeof(uint32_t) * (blocks + 1); }
+} // namespace
+
+template <typename T> std::unique_ptr<T[]> compc::HybridHuffman<T>::transformed_copy(const T* array, std::size_t size) {
+  std::unique_ptr<T[]> heap_copy_array = nullptr;
+  if (this->map_negative_numbers || this->offset != 0) {
+    heap_copy_array = std::unique_ptr<T[]>(new T[size]);
+    std::memcpy(static_cast<void*>(heap_copy_array.get()), static_cast<const void*>(array), size * sizeof(T));
+    if (this->map_negative_numbers) {
+      this->transform_to_natural_numbers(heap_copy_array.get(), size);
+    }
+    if (this->offset != 0) {
+      this->add_offset(heap_copy_array.get(), size, this->offset);
+    }
+  }
+  return heap_copy_array;
+}
+
+template <typename T>
+std::unique_ptr<uint8_t[]> compc::HybridHuffman<T>::compress(const T* input_array, std::size_t& size) {
+  if (this->block_size == 0) {
+    return nullptr;
+  }
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  const std::size_t length = size;
+  std::unique_ptr<T[]> heap_copy_array = this->transformed_copy(input_array, length);
+  const T* array = heap_copy_array != nullptr ? heap_copy_array.get() : input_array;
+  std::vector<LengthCode> codes;
+  if (!plan_blocks(array, length, this->block_size, this->threads(), codes)) {
+    return nullptr;
+  }
+  const std::size_t blocks = codes.size();
+  std::vector<std::size_t> block_offsets(blocks + 1, stream_header_bytes(blocks));
+  for (std::size_t b = 0; b < blocks; b++) {
+    std::size_t block_bytes = (codes[b].bits + 7) / 8;
+    if (block_bytes > std::numeric_limits<uint32_t>::max()) {
+      return nullptr;
+    }
+    block_offsets[b + 1] = block_offsets[b] + block_bytes;
+  }
+  std::unique_ptr<uint8_t[]> compressed(new uint8_t[block_offsets[blocks]]);
+  uint8_t* compressed_ptr = compressed.get();
+  hlprs::store_le<uint32_t>(compressed_ptr, this->block_size);
+  for (std::size_t b = 0; b < blocks; b++) {
+    hlprs::store_le<uint32_t>(compressed_ptr + sizeof(uint32_t) * (b + 1),
+                              static_cast<uint32_t>(block_offsets[b + 1] - block_offsets[b]));
+  }
+  const std::size_t block_size_local = this->block_size;
+  int local_threads = threads_for(this->threads(), blocks);
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(array, codes, block_offsets, compressed_ptr)        \
+    firstprivate(length, block_size_local, blocks) num_threads(local_threads)
+  for (std::size_t b = 0; b < blocks; b++) {
+    encode_block(array, b * block_size_local, std::min((b + 1) * block_size_local, length), codes[b],
+                 compressed_ptr + block_offsets[b]);
+  }
+  size = block_offsets[blocks];
+  return compressed;
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::HybridHuffman<T>::decompress(const uint8_t* array, std::size_t binary_length,
+                                                         std::size_t array_length) {
+  if (binary_length < sizeof(uint32_t)) {
+    return nullptr;
+  }
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  const std::size_t block_size_local = hlprs::load_le<uint32_t>(array);
+  if (block_size_local == 0) {
+    return nullptr;
+  }
+  const std::size_t blocks = (array_length + block_size_local - 1) / block_size_local;
+  if (binary_length < stream_header_bytes(blocks)) {
+    return nullptr;
+  }
+  std::vector<std::size_t> block_offsets(blocks + 1, stream_header_bytes(blocks));
+  for (std::size_t b = 0; b < blocks; b++) {
+    block_offsets[b + 1] = block_offsets[b] + hlprs::load_le<uint32_t>(array + sizeof(uint32_t) * (b + 1));
+  }
+  if (block_offsets[blocks] > binary_length) {
+    return nullptr;
+  }
+  std::unique_ptr<T[]> uncomp(new T[array_length]);
+  T* uncomp_ptr = uncomp.get();
+  int local_threads = threads_for(this->threads(), blocks);
+  bool error = false;
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(array, block_offsets, uncomp_ptr)                  \
+    reduction(|| : error) firstprivate(array_length, block_size_local, blocks) num_threads(local_threads)
+  for (std::size_t b = 0; b < blocks; b++) {
+    std::size_t start = b * block_size_local;
+    std::size_t count = std::min(block_size_local, array_length - start);
+    error = error || !decode_block(array + block_offsets[b], block_offsets[b + 1] - block_offsets[b],
+                                   uncomp_ptr + start, count);
+  }
+  if (error) {
+    return nullptr;
+  }
+  if (this->offset != 0) {
+    this->add_offset(uncomp_ptr, array_length, static_cast<T>(-this->offset));
+  }
+  if (this->map_negative_numbers) {
+    this->transform_to_natural_numbers_reverse(uncomp_ptr, array_length);
+  }
+  return uncomp;
+}
+
+template <typename T>
+std::size_t compc::HybridHuffman<T>::get_compressed_length(const T* input_array, std::size_t length) {
+  compc::ThreadLease lease(this->thread_budget, this->num_threads);
+  std::unique_ptr<T[]> heap_copy_array = this->transformed_copy(input_array, length);
+  const T* array = heap_copy_array != nullptr ? heap_copy_array.get() : input_array;
+  std::vector<LengthCode> codes;
+  if (this->block_size == 0 || !plan_blocks(array, length, this->block_size, this->threads(), codes)) {
+    return 0;
+  }
+  std::size_t bytes = stream_header_bytes(codes.size());
+  for (const LengthCode& code : codes) {
+    bytes += (code.bits + 7) / 8;
+  }
+  return bytes;
+}
+
+template class compc::HybridHuffman<int16_t>;
+template class compc::HybridHuffman<uint16_t>;
+template class compc::HybridHuffman<int32_t>;
+template class compc::HybridHuffman<uint32_t>;
+template class compc::HybridHuffman<int64_t>;
+template class compc::HybridHuffman<uint64_t>;
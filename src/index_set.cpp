@@ -0,0 +1,297 @@
+#include "compintc/index_set.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+#include "compintc/helpers.hpp"
+
+namespace {
+constexpr std::size_t bitmap_words = compc::index_block_size / 64;
+constexpr std::size_t bitmap_bytes = bitmap_words * sizeof(uint64_t);
+constexpr std::size_t run_bytes = 2 * sizeof(uint16_t);
+
+std::unique_ptr<compc::EliasBase<uint32_t>> make_codec(compc::CodecId codec, int num_threads,
+                                                       compc::ThreadBudget* thread_budget) {
+  std::unique_ptr<compc::EliasBase<uint32_t>> elias = compc::make_elias<uint32_t>(codec);
+  if (elias != nullptr && num_threads > 0) {
+    elias->num_threads = num_threads;
+  }
+  if (elias != nullptr) {
+    elias->thread_budget = thread_budget;
+  }
+  return elias;
+}
+
+int threads_for(int num_threads, std::size_t work_items) {
+  if (work_items < static_cast<std::size_t>(num_threads)) {
+    return std::max(static_cast<int>(work_items), 1);
+  }
+  return num_threads;
+}
+
+template <typename T> bool is_negative(T value) {
+  if constexpr (std::is_signed_v<T>) {
+    return value < 0;
+  } else {
+    return false;
+  }
+}
+
+// the indices of a block relative to its start
+template <typename T> uint32_t low_bits(T index) {
+  return static_cast<uint32_t>(static_cast<uint64_t>(index) & (compc::index_block_size - 1));
+}
+
+std::size_t count_runs(const uint32_t* low, std::size_t length) {
+  std::size_t runs = 1;
+  for (std::size_t i = 1; i < length; i++) {
+    runs += static_cast<std::size_t>(low[i] != low[i - 1] + 1);
+  }
+  return runs;
+}
+
+// turns the low bits into gaps in situ, every gap is positive
+void to_gaps(uint32_t* low, std::size_t length) {
+  for (std::size_t i = length - 1; i > 0; i--) {
+    low[i] -= low[i - 1];
+  }
+  low[0] += 1;
+}
+} // namespace
+
+template <typename T>
+compc::CompressedIndexSet compc::compress_index_set(const T* indices, std::size_t length, CodecId codec,
+                                                    int num_threads, ThreadBudget* thread_budget) {
+  compc::CompressedIndexSet set;
+  set.codec = codec;
+  set.count = length;
+  std::unique_ptr<compc::EliasBase<uint32_t>> elias = make_codec(codec, num_threads, thread_budget);
+  if (elias == nullptr) {
+    return compc::CompressedIndexSet{};
+  }
+  compc::ThreadLease lease(elias->thread_budget, elias->num_threads);
+  // block boundaries, found in one serial pass over the sorted indices
+  std::vector<std::size_t> block_starts;
+  for (std::size_t i = 0; i < length; i++) {
+    if (is_negative(indices[i]) || (i > 0 && indices[i] <= indices[i - 1])) {
+      return compc::CompressedIndexSet{};
+    }
+    uint64_t key = static_cast<uint64_t>(indices[i]) >> index_block_bits;
+    if (i == 0 || key != set.blocks.back().key) {
+      block_starts.push_back(i);
+      set.blocks.push_back(compc::IndexBlock{key, BlockContainer::gaps, 0, 0, 0});
+    }
+  }
+  block_starts.push_back(length);
+  const std::size_t number_of_blocks = set.blocks.size();
+  const int local_threads = threads_for(elias->threads(), number_of_blocks);
+  std::vector<compc::IndexBlock>& blocks = set.blocks;
+  compc::EliasBase<uint32_t>& kernels = *elias;
+
+  // pick the smallest container of every block
+  std::vector<std::size_t> gap_bits(number_of_blocks, 0);
+#pragma omp parallel default(none) shared(indices, block_starts, blocks, kernels, gap_bits)                           \
+    firstprivate(number_of_blocks) num_threads(local_threads)
+  {
+    std::vector<uint32_t> low;
+#pragma omp for schedule(dynamic, 1)
+    for (std::size_t b = 0; b < number_of_blocks; b++) {
+      std::size_t cardinality = block_starts[b + 1] - block_starts[b];
+      low.resize(cardinality);
+      for (std::size_t i = 0; i < cardinality; i++) {
+        low[i] = low_bits(indices[block_starts[b] + i]);
+      }
+      std::size_t runs = count_runs(low.data(), cardinality);
+      to_gaps(low.data(), cardinality);
+      bool error = false;
+      gap_bits[b] = kernels.chunk_bit_length(low.data(), 0, cardinality, error);
+      std::size_t gap_bytes = (gap_bits[b] + 7) / 8;
+      IndexBlock& block = blocks[b];
+      block.cardinality = static_cast<uint32_t>(cardinality);
+      block.container = BlockContainer::gaps;
+      block.bytes = gap_bytes;
+      if (bitmap_bytes < block.bytes) {
+        block.container = BlockContainer::bitmap;
+        block.bytes = bitmap_bytes;
+      }
+      if (runs * run_bytes < block.bytes) {
+        block.container = BlockContainer::runs;
+        block.bytes = runs * run_bytes;
+      }
+    }
+  }
+  std::size_t offset = 0;
+  for (IndexBlock& block : blocks) {
+    block.offset = offset;
+    offset += block.bytes;
+  }
+  set.payload_bytes = offset;
+  // zero initialize, the bitmaps and the edges of the gap-coded blocks rely on it
+  set.payload = std::make_unique<uint8_t[]>(std::max<std::size_t>(offset, 1));
+  uint8_t* payload = set.payload.get();
+
+#pragma omp parallel default(none) shared(indices, block_starts, blocks, kernels, gap_bits, payload)                  \
+    firstprivate(number_of_blocks) num_threads(local_threads)
+  {
+    std::vector<uint32_t> low;
+#pragma omp for schedule(dynamic, 1)
+    for (std::size_t b = 0; b < number_of_blocks; b++) {
+      const IndexBlock& block = blocks[b];
+      const T* block_indices = indices + block_starts[b];
+      uint8_t* out = payload + block.offset;
+      switch (block.container) {
+      case BlockContainer::gaps:
+        low.resize(block.cardinality);
+        for (std::size_t i = 0; i < block.cardinality; i++) {
+          low[i] = low_bits(block_indices[i]);
+        }
+        to_gaps(low.data(), block.cardinality);
+        kernels.encode_chunk(low.data(), 0, block.cardinality, 0, gap_bits[b], out);
+        break;
+      case BlockContainer::bitmap:
+        for (std::size_t i = 0; i < block.cardinality; i++) {
+          uint32_t bit = low_bits(block_indices[i]);
+          out[bit / 8] = static_cast<uint8_t>(out[bit / 8] | (1U << (bit % 8)));
+        }
+        break;
+      case BlockContainer::runs: {
+        std::size_t run = 0;
+        uint32_t run_start = low_bits(block_indices[0]);
+        for (std::size_t i = 1; i <= block.cardinality; i++) {
+          uint32_t previous = low_bits(block_indices[i - 1]);
+          if (i == block.cardinality || low_bits(block_indices[i]) != previous + 1) {
+            hlprs::store_le<uint16_t>(out + run * run_bytes, static_cast<uint16_t>(run_start));
+            hlprs::store_le<uint16_t>(out + run * run_bytes + 2, static_cast<uint16_t>(previous - run_start));
+            run++;
+            if (i < block.cardinality) {
+              run_start = low_bits(block_indices[i]);
+            }
+          }
+        }
+        break;
+      }
+      }
+    }
+  }
+  return set;
+}
+
+template <typename T>
+std::unique_ptr<T[]> compc::decompress_index_set(const CompressedIndexSet& set, int num_threads,
+                                                 ThreadBudget* thread_budget) {
+  std::unique_ptr<compc::EliasBase<uint32_t>> elias = make_codec(set.codec, num_threads, thread_budget);
+  if (elias == nullptr) {
+    return nullptr;
+  }
+  compc::ThreadLease lease(elias->thread_budget, elias->num_threads);
+  const std::size_t number_of_blocks = set.blocks.size();
+  std::vector<std::size_t> output_starts(number_of_blocks + 1, 0);
+  for (std::size_t b = 0; b < number_of_blocks; b++) {
+    const IndexBlock& block = set.blocks[b];
+    if (block.offset + block.bytes > set.payload_bytes || block.cardinality > index_block_size ||
+        block.key > (static_cast<uint64_t>(std::numeric_limits<T>::max()) >> index_block_bits)) {
+      return nullptr;
+    }
+    output_starts[b + 1] = output_starts[b] + block.cardinality;
+  }
+  if (output_starts[number_of_blocks] != set.count) {
+    return nullptr;
+  }
+  std::unique_ptr<T[]> output(new T[std::max<std::size_t>(set.count, 1)]);
+  T* output_ptr = output.get();
+  const std::vector<IndexBlock>& blocks = set.blocks;
+  const uint8_t* payload = set.payload.get();
+  compc::EliasBase<uint32_t>& kernels = *elias;
+  bool error = false;
+#pragma omp parallel default(none) shared(blocks, payload, kernels, output_starts, output_ptr)                        \
+    reduction(|| : error) firstprivate(number_of_blocks) num_threads(threads_for(elias->threads(), number_of_blocks))
+  {
+    std::vector<uint32_t> low;
+#pragma omp for schedule(dynamic, 1)
+    for (std::size_t b = 0; b < number_of_blocks; b++) {
+      const IndexBlock& block = blocks[b];
+      const uint8_t* in = payload + block.offset;
+      T* out = output_ptr + output_starts[b];
+      const uint64_t base = block.key << index_block_bits;
+      std::size_t written = 0;
+      switch (block.container) {
+      case BlockContainer::gaps: {
+        low.resize(block.cardinality);
+        kernels.decode_chunk(in, block.bytes, 0, low.data(), block.cardinality);
+        uint64_t index = base - 1;
+        for (; written < block.cardinality; written++) {
+          index += low[written];
+          out[written] = static_cast<T>(index);
+        }
+        error = error || index >= base + index_block_size;
+        break;
+      }
+      case BlockContainer::bitmap:
+        for (std::size_t w = 0; w < bitmap_words && block.bytes == bitmap_bytes; w++) {
+          auto word = hlprs::load_le<uint64_t>(in + w * sizeof(uint64_t));
+          if (written + static_cast<std::size_t>(__builtin_popcountll(word)) > block.cardinality) {
+            error = true;
+            break;
+          }
+          while (word != 0) {
+            out[written++] = static_cast<T>(base + w * 64 + static_cast<uint64_t>(__builtin_ctzll(word)));
+            word &= word - 1;
+          }
+        }
+        break;
+      case BlockContainer::runs:
+        for (std::size_t run = 0; run < block.bytes / run_bytes; run++) {
+          auto start = hlprs::load_le<uint16_t>(in + run * run_bytes);
+          std::size_t run_length = hlprs::load_le<uint16_t>(in + run * run_bytes + 2) + std::size_t{1};
+          if (written + run_length > block.cardinality || start + run_length > index_block_size) {
+            error = true;
+            break;
+          }
+          for (std::size_t i = 0; i < run_length; i++) {
+            out[written++] = static_cast<T>(base + start + i);
+          }
+        }
+        break;
+      default:
+        error = true;
+      }
+      error = error || (block.container != BlockContainer::gaps && written != block.cardinality);
+    }
+  }
+  if (error) {
+    return nullptr;
+  }
+  return output;
+}
+
+template compc::CompressedIndexSet compc::compress_index_set<int16_t>(const int16_t*, std::size_t, CodecId, int,
+                                                                      ThreadBudget*);
+template compc::CompressedIndexSet compc::compress_index_set<uint16_t>(const uint16_t*, std::size_t, CodecId, int,
+                                                                       ThreadBudget*);
+template compc::CompressedIndexSet compc::compress_index_set<int32_t>(const int32_t*, std::size_t, CodecId, int,
+                                                                      ThreadBudget*);
+template compc::CompressedIndexSet compc::compress_index_set<uint32_t>(const uint32_t*, std::size_t, CodecId, int,
+                                                                       ThreadBudget*);
+template compc::CompressedIndexSet compc::compress_index_set<int64_t>(const int64_t*, std::size_t, CodecId, int,
+                                                                      ThreadBudget*);
+template compc::CompressedIndexSet compc::compress_index_set<uint64_t>(const uint64_t*, std::size_t, CodecId, int,
+                                                                       ThreadBudget*);
+
+template std::unique_ptr<int16_t[]> compc::decompress_index_set<int16_t>(const CompressedIndexSet&, int, ThreadBudget*);
+template std::unique_ptr<uint16_t[]> compc::decompress_index_set<uint16_t>(const CompressedIndexSet&, int,
+                                                                           ThreadBudget*);
+template std::unique_ptr<int32_t[]> compc::decompress_index_set<int32_t>(const CompressedIndexSet&, int, ThreadBudget*);
+template std::unique_ptr<uint32_t[]> compc::decompress_index_set<uint32_t>(const CompressedIndexSet&, int,
+                                                                           ThreadBudget*);
+template std::unique_ptr<int64_t[]> compc::decompress_index_set<int64_t>(const CompressedIndexSet&, int, ThreadBudget*);
+template std::unique_ptr<uint64_t[]> compc::decompress_index_set<uint64_t>(const CompressedIndexSet&, int,
+                                                                           ThreadBudget*);
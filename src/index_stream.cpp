@@ -0,0 +1,366 @@
+#include "compintc/index_stream.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+#include "compintc/helpers.hpp"
+
+namespace {
+// turns the decoded gaps of a block into indices in place, returns false for invalid gaps
+bool gaps_to_indices(uint64_t* block, std::size_t count, bool& started, uint64_t& last) {
+  for (std::size_t i = 0; i < count; i++) {
+    uint64_t gap = block[i];
+    if (gap == 0 || (started && last > std::numeric_limits<uint64_t>::max() - gap)) {
+      return false;
+    }
+    last = started ? last + gap : gap - 1;
+    started = true;
+    block[i] = last;
+  }
+  return true;
+}
+
+// whether the stream has a skip pointer for every block but the first
+bool has_skips(const compc::GapStream& stream) {
+  std::size_t blocks = (stream.count + compc::stream_block_size - 1) / compc::stream_block_size;
+  return !stream.skips.empty() && stream.skips.size() + 1 == blocks;
+}
+
+constexpr uint8_t stream_magic[3] = {'C', 'G', 'S'};
+constexpr uint8_t flag_skip_pointers = 1U;
+constexpr std::size_t skip_bytes = 2 * sizeof(uint64_t);
+} // namespace
+
+compc::GapStreamReader::GapStreamReader(const GapStream& stream)
+    : codec(compc::make_elias<uint64_t>(stream.codec)), data(stream.data.data()), length(stream.data.size()),
+      count(stream.count), skips(has_skips(stream) ? &stream.skips : nullptr), remaining(stream.count),
+      error(codec == nullptr) {}
+
+bool compc::GapStreamReader::refill() {
+  if (error || remaining == 0) {
+    return false;
+  }
+  std::size_t block_count = std::min(remaining, stream_block_size);
+  block.resize(block_count);
+  bit = codec->decode_chunk(data, length, bit, block.data(), block_count);
+  if (bit > length * 8 || !gaps_to_indices(block.data(), block_count, started, last)) {
+    error = true;
+    return false;
+  }
+  remaining -= block_count;
+  position = 0;
+  return true;
+}
+
+void compc::GapStreamReader::jump(std::size_t b) {
+  const compc::GapSkip& skip = (*skips)[b - 1];
+  bit = skip.bit;
+  last = skip.last;
+  started = true;
+  remaining = count - b * stream_block_size;
+  block.clear();
+  position = 0;
+}
+
+bool compc::GapStreamReader::next(uint64_t& index) {
+  if (position == block.size() && !refill()) {
+    return false;
+  }
+  index = block[position++];
+  return true;
+}
+
+bool compc::GapStreamReader::seek(uint64_t target, uint64_t& index) {
+  if (skips != nullptr && (position == block.size() || block.back() < target)) {
+    // the last block that follows an index below the target, the blocks before it only hold smaller indices
+    auto after = std::lower_bound(skips->begin(), skips->end(), target,
+                                  [](const compc::GapSkip& skip, uint64_t value) { return skip.last < value; });
+    auto b = static_cast<std::size_t>(after - skips->begin());
+    if (b > (count - remaining) / stream_block_size) {
+      jump(b);
+    }
+  }
+  // whole blocks below the target are skipped without a search
+  while (position == block.size() || block.back() < target) {
+    position = block.size();
+    if (!refill()) {
+      return false;
+    }
+  }
+  position = static_cast<std::size_t>(
+      std::lower_bound(block.begin() + static_cast<std::ptrdiff_t>(position), block.end(), target) - block.begin());
+  index = block[position++];
+  return true;
+}
+
+compc::GapStreamWriter::GapStreamWriter(CodecId codec_id)
+    : codec(compc::make_elias<uint64_t>(codec_id)), stream(std::make_unique<GapStream>()),
+      error(codec == nullptr) {
+  stream->codec = codec_id;
+  gaps.reserve(stream_block_size);
+}
+
+void compc::GapStreamWriter::flush() {
+  if (gaps.empty() || error) {
+    return;
+  }
+  bool invalid = false;
+  std::size_t block_bits = codec->chunk_bit_length(gaps.data(), 0, gaps.size(), invalid);
+  // the new bytes are zero initialized, the encoder only ors into the shared byte
+  stream->data.resize((bits + block_bits + 7) / 8, 0);
+  codec->encode_chunk(gaps.data(), 0, gaps.size(), bits, bits + block_bits, stream->data.data());
+  bits += block_bits;
+  error = error || invalid;
+  gaps.clear();
+}
+
+bool compc::GapStreamWriter::push(uint64_t index) {
+  if ((started && index <= last) || index == std::numeric_limits<uint64_t>::max()) {
+    error = true;
+    return false;
+  }
+  if (started && gaps.empty()) {
+    stream->skips.push_back(compc::GapSkip{last, bits});
+  }
+  gaps.push_back(started ? index - last : index + 1);
+  last = index;
+  started = true;
+  stream->count++;
+  if (gaps.size() == stream_block_size) {
+    flush();
+  }
+  return true;
+}
+
+std::unique_ptr<compc::GapStream> compc::GapStreamWriter::finish() {
+  flush();
+  if (error) {
+    return nullptr;
+  }
+  return std::move(stream);
+}
+
+template <typename T>
+std::unique_ptr<compc::GapStream> compc::encode_gap_stream(const T* indices, std::size_t length, CodecId codec) {
+  compc::GapStreamWriter writer(codec);
+  for (std::size_t i = 0; i < length; i++) {
+    if constexpr (std::is_signed_v<T>) {
+      if (indices[i] < 0) {
+        return nullptr;
+      }
+    }
+    if (!writer.push(static_cast<uint64_t>(indices[i]))) {
+      return nullptr;
+    }
+  }
+  return writer.finish();
+}
+
+template <typename T> std::unique_ptr<T[]> compc::decode_gap_stream(const GapStream& stream) {
+  compc::GapStreamReader reader(stream);
+  std::unique_ptr<T[]> output(new T[std::max<std::size_t>(stream.count, 1)]);
+  uint64_t index = 0;
+  for (std::size_t i = 0; i < stream.count; i++) {
+    if (!reader.next(index) || index > static_cast<uint64_t>(std::numeric_limits<T>::max())) {
+      return nullptr;
+    }
+    output[i] = static_cast<T>(index);
+  }
+  return output;
+}
+
+bool compc::lower_bound(const GapStream& stream, uint64_t value, uint64_t& index) {
+  compc::GapStreamReader reader(stream);
+  return reader.seek(value, index);
+}
+
+bool compc::contains(const GapStream& stream, uint64_t value) {
+  uint64_t index = 0;
+  return compc::lower_bound(stream, value, index) && index == value;
+}
+
+bool compc::add_skip_pointers(GapStream& stream) {
+  std::unique_ptr<compc::EliasBase<uint64_t>> codec = compc::make_elias<uint64_t>(stream.codec);
+  if (codec == nullptr) {
+    return false;
+  }
+  std::vector<compc::GapSkip> skips;
+  std::vector<uint64_t> block(stream_block_size);
+  std::size_t bit = 0;
+  uint64_t last = 0;
+  bool started = false;
+  for (std::size_t start = 0; start < stream.count; start += stream_block_size) {
+    if (started) {
+      skips.push_back(compc::GapSkip{last, bit});
+    }
+    std::size_t block_count = std::min(stream_block_size, stream.count - start);
+    bit = codec->decode_chunk(stream.data.data(), stream.data.size(), bit, block.data(), block_count);
+    if (bit > stream.data.size() * 8 || !gaps_to_indices(block.data(), block_count, started, last)) {
+      return false;
+    }
+  }
+  stream.skips = std::move(skips);
+  return true;
+}
+
+std::vector<uint8_t> compc::serialize_gap_stream(const GapStream& stream, bool skip_pointers) {
+  const bool with_skips = skip_pointers && has_skips(stream);
+  uint8_t header[gap_stream_header_size] = {};
+  std::memcpy(header, stream_magic, sizeof(stream_magic));
+  header[3] = gap_stream_version;
+  header[4] = static_cast<uint8_t>(stream.codec);
+  header[5] = with_skips ? flag_skip_pointers : uint8_t{0};
+  hlprs::store_le<uint64_t>(header + 8, stream.count);
+  hlprs::store_le<uint64_t>(header + 16, stream.data.size());
+  std::vector<uint8_t> bytes;
+  bytes.reserve(gap_stream_header_size + (with_skips ? stream.skips.size() * skip_bytes : 0) + stream.data.size());
+  bytes.insert(bytes.end(), header, header + gap_stream_header_size);
+  for (std::size_t b = 0; with_skips && b < stream.skips.size(); b++) {
+    uint8_t entry[skip_bytes];
+    hlprs::store_le<uint64_t>(entry, stream.skips[b].last);
+    hlprs::store_le<uint64_t>(entry + sizeof(uint64_t), stream.skips[b].bit);
+    bytes.insert(bytes.end(), entry, entry + skip_bytes);
+  }
+  bytes.insert(bytes.end(), stream.data.begin(), stream.data.end());
+  return bytes;
+}
+
+std::unique_ptr<compc::GapStream> compc::deserialize_gap_stream(const uint8_t* bytes, std::size_t length) {
+  if (bytes == nullptr || length < gap_stream_header_size ||
+      std::memcmp(bytes, stream_magic, sizeof(stream_magic)) != 0 || bytes[3] != gap_stream_version ||
+      bytes[4] < static_cast<uint8_t>(CodecId::gamma) || bytes[4] > static_cast<uint8_t>(CodecId::omega)) {
+    return nullptr;
+  }
+  const bool with_skips = (bytes[5] & flag_skip_pointers) != 0;
+  const auto count = hlprs::load_le<uint64_t>(bytes + 8);
+  const auto data_bytes = hlprs::load_le<uint64_t>(bytes + 16);
+  // every gap takes at least one bit
+  if (data_bytes > length - gap_stream_header_size || count > data_bytes * 8) {
+    return nullptr;
+  }
+  const std::size_t blocks = (count + stream_block_size - 1) / stream_block_size;
+  const std::size_t skip_count = with_skips && blocks > 1 ? blocks - 1 : 0;
+  if (skip_count * skip_bytes != length - gap_stream_header_size - data_bytes) {
+    return nullptr;
+  }
+  auto stream = std::make_unique<GapStream>();
+  stream->codec = static_cast<CodecId>(bytes[4]);
+  stream->count = count;
+  stream->skips.resize(skip_count);
+  const uint8_t* table = bytes + gap_stream_header_size;
+  for (std::size_t b = 0; b < skip_count; b++) {
+    GapSkip& skip = stream->skips[b];
+    skip.last = hlprs::load_le<uint64_t>(table + b * skip_bytes);
+    skip.bit = hlprs::load_le<uint64_t>(table + b * skip_bytes + sizeof(uint64_t));
+    // the blocks start in order inside the data, every block holds at least one gap
+    bool in_order = b == 0 || (skip.bit > stream->skips[b - 1].bit && skip.last > stream->skips[b - 1].last);
+    if (skip.bit > data_bytes * 8 || !in_order) {
+      return nullptr;
+    }
+  }
+  const uint8_t* data = table + skip_count * skip_bytes;
+  stream->data.assign(data, data + data_bytes);
+  return stream;
+}
+
+std::unique_ptr<compc::GapStream> compc::union_streams(const std::vector<const GapStream*>& streams, CodecId codec) {
+  std::vector<compc::GapStreamReader> readers;
+  readers.reserve(streams.size());
+  // smallest current index of every reader first
+  using Head = std::pair<uint64_t, std::size_t>;
+  std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+  uint64_t index = 0;
+  for (std::size_t s = 0; s < streams.size(); s++) {
+    readers.emplace_back(*streams[s]);
+    if (readers[s].next(index)) {
+      heads.emplace(index, s);
+    }
+  }
+  compc::GapStreamWriter writer(codec);
+  bool started = false;
+  uint64_t last = 0;
+  while (!heads.empty()) {
+    auto [smallest, s] = heads.top();
+    heads.pop();
+    if (!started || smallest != last) {
+      writer.push(smallest);
+      last = smallest;
+      started = true;
+    }
+    if (readers[s].next(index)) {
+      heads.emplace(index, s);
+    }
+  }
+  for (const compc::GapStreamReader& reader : readers) {
+    if (!reader.valid()) {
+      return nullptr;
+    }
+  }
+  return writer.finish();
+}
+
+std::unique_ptr<compc::GapStream> compc::intersect_streams(const std::vector<const GapStream*>& streams,
+                                                           CodecId codec) {
+  std::vector<compc::GapStreamReader> readers;
+  readers.reserve(streams.size());
+  for (const compc::GapStream* stream : streams) {
+    readers.emplace_back(*stream);
+  }
+  compc::GapStreamWriter writer(codec);
+  uint64_t candidate = 0;
+  bool more = !readers.empty() && readers[0].next(candidate);
+  // leapfrog: every reader seeks to the candidate, a larger result becomes the new candidate
+  std::size_t agreeing = 1;
+  std::size_t s = 1;
+  while (more) {
+    if (agreeing == readers.size()) {
+      writer.push(candidate);
+      more = readers[0].next(candidate);
+      agreeing = 1;
+      s = 1;
+      continue;
+    }
+    uint64_t found = 0;
+    std::size_t current = s % readers.size();
+    if (!readers[current].seek(candidate, found)) {
+      break;
+    }
+    if (found == candidate) {
+      agreeing++;
+    } else {
+      candidate = found;
+      agreeing = 1;
+    }
+    s = current + 1;
+  }
+  for (const compc::GapStreamReader& reader : readers) {
+    if (!reader.valid()) {
+      return nullptr;
+    }
+  }
+  return writer.finish();
+}
+
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<int16_t>(const int16_t*, std::size_t, CodecId);
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<uint16_t>(const uint16_t*, std::size_t, CodecId);
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<int32_t>(const int32_t*, std::size_t, CodecId);
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<uint32_t>(const uint32_t*, std::size_t, CodecId);
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<int64_t>(const int64_t*, std::size_t, CodecId);
+template std::unique_ptr<compc::GapStream> compc::encode_gap_stream<uint64_t>(const uint64_t*, std::size_t, CodecId);
+
+template std::unique_ptr<int16_t[]> compc::decode_gap_stream<int16_t>(const GapStream&);
+template std::unique_ptr<uint16_t[]> compc::decode_gap_stream<uint16_t>(const GapStream&);
+template std::unique_ptr<int32_t[]> compc::decode_gap_stream<int32_t>(const GapStream&);
+template std::unique_ptr<uint32_t[]> compc::decode_gap_stream<uint32_t>(const GapStream&);
+template std::unique_ptr<int64_t[]> compc::decode_gap_stream<int64_t>(const GapStream&);
+template std::unique_ptr<uint64_t[]> compc::decode_gap_stream<uint64_t>(const GapStream&);
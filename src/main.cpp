@@ -0,0 +1,357 @@
+#include <fcntl.h>
+#include <omp.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "compintc/container.hpp"
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+
+namespace {
+
+const char* usage = R"(usage: compintc compress [options] <input> <output>
+       compintc decompress [options] <input> <output>
+       compintc info <input>
+
+Compresses raw files of native endian integers into the framed format and back.
+
+options:
+  -c, --codec <gamma|delta|omega>   codec used to compress (default: gamma)
+  -t, --type <int16|uint16|int32|uint32|int64|uint64>
+                                    type of the raw integers (default: int64)
+  -j, --threads <n>                 number of threads (default: OMP_NUM_THREADS or 1)
+  --offset <n>                      offset added before compressing
+  --map-negative                    map negative numbers to positive ones
+  --checksums                       store a CRC32C checksum of every chunk
+  --lsb-first                       write the LSB-first bit order
+  --no-chunk-index                  do not store the chunk index
+)";
+
+struct Options {
+  std::string command{};
+  std::string input{};
+  std::string output{};
+  compc::CodecId codec = compc::CodecId::gamma;
+  std::string type = "int64";
+  int threads = 0;
+  long long offset = 0;
+  bool map_negative_numbers = false;
+  bool checksums = false;
+  bool chunk_index = true;
+  bool lsb_first = false;
+};
+
+class MappedFile {
+  /*
+    Read only (input) or read write (output) memory mapping of a whole file.
+  */
+public:
+  MappedFile() = default;
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  ~MappedFile() {
+    if (data != nullptr && data != MAP_FAILED) {
+      munmap(data, size);
+    }
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+
+  bool open_input(const std::string& path) {
+    fd = open(path.c_str(), O_RDONLY);
+    struct stat file_stat {};
+    if (fd < 0 || fstat(fd, &file_stat) != 0) {
+      return false;
+    }
+    size = static_cast<std::size_t>(file_stat.st_size);
+    if (size == 0) {
+      return true;
+    }
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+      return false;
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    return true;
+  }
+
+  bool open_output(const std::string& path, std::size_t length) {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(length)) != 0) {
+      return false;
+    }
+    size = length;
+    if (size == 0) {
+      return true;
+    }
+    data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    return data != MAP_FAILED;
+  }
+
+  uint8_t* bytes() const { return static_cast<uint8_t*>(data); }
+  std::size_t length() const { return size; }
+
+private:
+  int fd{-1};
+  void* data{nullptr};
+  std::size_t size{0};
+};
+
+// copies the buffer into a new output file, the pages are touched in parallel
+bool write_output(const std::string& path, const uint8_t* buffer, std::size_t length, int threads) {
+  MappedFile output;
+  if (!output.open_output(path, length)) {
+    std::cerr << "compintc: cannot write " << path << ": " << std::strerror(errno) << std::endl;
+    return false;
+  }
+  constexpr std::size_t block = std::size_t{1} << 20U;
+  auto blocks = static_cast<std::ptrdiff_t>((length + block - 1) / block);
+  uint8_t* destination = output.bytes();
+#pragma omp parallel for schedule(static) default(none) shared(destination, buffer) firstprivate(blocks, length)     \
+    num_threads(threads)
+  for (std::ptrdiff_t b = 0; b < blocks; b++) {
+    std::size_t start = static_cast<std::size_t>(b) * block;
+    std::size_t end = std::min(start + block, length);
+    std::memcpy(destination + start, buffer + start, end - start);
+  }
+  return true;
+}
+
+void print_throughput(const char* what, std::size_t values, std::size_t raw_bytes, std::size_t compressed_bytes,
+                      std::chrono::steady_clock::duration elapsed) {
+  double seconds = std::chrono::duration<double>(elapsed).count();
+  std::cout << what << " " << values << " values in " << seconds * 1e3 << " ms: " << raw_bytes << " -> "
+            << compressed_bytes << " bytes, "
+            << static_cast<double>(compressed_bytes * 8) / static_cast<double>(std::max<std::size_t>(values, 1))
+            << " bits/value, " << static_cast<double>(values) / seconds / 1e6 << " M values/s, "
+            << static_cast<double>(raw_bytes) / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+template <typename T> int compress_file(const Options& options) {
+  MappedFile input;
+  if (!input.open_input(options.input)) {
+    std::cerr << "compintc: cannot read " << options.input << ": " << std::strerror(errno) << std::endl;
+    return 1;
+  }
+  if (input.length() % sizeof(T) != 0) {
+    std::cerr << "compintc: the size of " << options.input << " is not a multiple of " << sizeof(T) << " bytes"
+              << std::endl;
+    return 1;
+  }
+  std::unique_ptr<compc::EliasBase<T>> codec =
+      compc::make_elias<T>(options.codec, static_cast<T>(options.offset), options.map_negative_numbers);
+  if (options.threads > 0) {
+    codec->num_threads = options.threads;
+  }
+  if (options.lsb_first) {
+    codec->bit_order = compc::BitOrder::lsb_first;
+  }
+  std::size_t values = input.length() / sizeof(T);
+  std::size_t size = values;
+  auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<T>(
+      *codec, reinterpret_cast<const T*>(input.bytes()), size, options.chunk_index, options.checksums);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (frame == nullptr) {
+    std::cerr << "compintc: the input contains values that cannot be encoded, consider --offset or --map-negative"
+              << std::endl;
+    return 1;
+  }
+  print_throughput("compressed", values, input.length(), size, elapsed);
+  return write_output(options.output, frame.get(), size, codec->num_threads) ? 0 : 1;
+}
+
+template <typename T> int decompress_file(const Options& options, const MappedFile& input) {
+  std::size_t values = 0;
+  std::vector<std::size_t> corrupt_chunks;
+  auto start = std::chrono::steady_clock::now();
+  std::unique_ptr<T[]> output =
+      compc::decompress_auto<T>(input.bytes(), input.length(), values, options.threads, &corrupt_chunks);
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  if (output == nullptr) {
+    std::cerr << "compintc: " << options.input << " is corrupt";
+    for (std::size_t chunk : corrupt_chunks) {
+      std::cerr << " " << chunk;
+    }
+    std::cerr << std::endl;
+    return 1;
+  }
+  print_throughput("decompressed", values, values * sizeof(T), input.length(), elapsed);
+  int threads = options.threads > 0 ? options.threads : 1;
+  return write_output(options.output, reinterpret_cast<const uint8_t*>(output.get()), values * sizeof(T), threads)
+             ? 0
+             : 1;
+}
+
+template <template <typename> class Command, typename... Args> int dispatch(const std::string& type, Args&&... args) {
+  if (type == "int16") {
+    return Command<int16_t>::run(args...);
+  }
+  if (type == "uint16") {
+    return Command<uint16_t>::run(args...);
+  }
+  if (type == "int32") {
+    return Command<int32_t>::run(args...);
+  }
+  if (type == "uint32") {
+    return Command<uint32_t>::run(args...);
+  }
+  if (type == "int64") {
+    return Command<int64_t>::run(args...);
+  }
+  if (type == "uint64") {
+    return Command<uint64_t>::run(args...);
+  }
+  std::cerr << "compintc: unknown type " << type << std::endl;
+  return 1;
+}
+
+template <typename T> struct CompressCommand {
+  static int run(const Options& options) { return compress_file<T>(options); }
+};
+
+template <typename T> struct DecompressCommand {
+  static int run(const Options& options, const MappedFile& input) { return decompress_file<T>(options, input); }
+};
+
+std::string type_name(const compc::FrameHeader& header) {
+  return std::string(header.type_signed ? "int" : "uint") + std::to_string(header.type_width * 8);
+}
+
+const char* codec_name(compc::CodecId codec) {
+  switch (codec) {
+  case compc::CodecId::gamma:
+    return "gamma";
+  case compc::CodecId::delta:
+    return "delta";
+  case compc::CodecId::omega:
+    return "omega";
+  }
+  return "unknown";
+}
+
+int read_frame(const Options& options, MappedFile& input, compc::FrameHeader& header) {
+  if (!input.open_input(options.input)) {
+    std::cerr << "compintc: cannot read " << options.input << ": " << std::strerror(errno) << std::endl;
+    return 1;
+  }
+  if (!compc::read_frame_header(input.bytes(), input.length(), header)) {
+    std::cerr << "compintc: " << options.input << " is not a valid frame" << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int info(const Options& options) {
+  MappedFile input;
+  compc::FrameHeader header;
+  if (read_frame(options, input, header) != 0) {
+    return 1;
+  }
+  std::cout << "version:      " << static_cast<int>(header.version) << "\n"
+            << "codec:        " << codec_name(header.codec) << "\n"
+            << "type:         " << type_name(header) << "\n"
+            << "values:       " << header.count << "\n"
+            << "offset:       " << header.offset << "\n"
+            << "map negative: " << (header.map_negative_numbers ? "yes" : "no") << "\n"
+            << "payload:      " << header.payload_bytes << " bytes\n"
+            << "chunk index:  " << (header.has_chunk_index ? std::to_string(header.chunk_count) + " chunks" : "no")
+            << "\n"
+            << "checksums:    " << (header.has_checksums ? "yes" : "no") << "\n"
+            << "bit order:    " << (header.bit_order == compc::BitOrder::lsb_first ? "lsb first" : "msb first")
+            << std::endl;
+  return compc::verify_frame(input.bytes(), input.length()) ? 0 : 1;
+}
+
+bool parse_codec(const std::string& name, compc::CodecId& codec) {
+  for (compc::CodecId id : {compc::CodecId::gamma, compc::CodecId::delta, compc::CodecId::omega}) {
+    if (name == codec_name(id)) {
+      codec = id;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool parse_arguments(int argc, char** argv, Options& options) {
+  std::vector<std::string> positional;
+  for (int i = 1; i < argc; i++) {
+    std::string argument = argv[i];
+    bool has_value = i + 1 < argc;
+    if ((argument == "-c" || argument == "--codec") && has_value) {
+      if (!parse_codec(argv[++i], options.codec)) {
+        return false;
+      }
+    } else if ((argument == "-t" || argument == "--type") && has_value) {
+      options.type = argv[++i];
+    } else if ((argument == "-j" || argument == "--threads") && has_value) {
+      options.threads = std::max(static_cast<int>(std::strtol(argv[++i], nullptr, 10)), 1);
+    } else if (argument == "--offset" && has_value) {
+      options.offset = std::strtoll(argv[++i], nullptr, 10);
+    } else if (argument == "--map-negative") {
+      options.map_negative_numbers = true;
+    } else if (argument == "--checksums") {
+      options.checksums = true;
+    } else if (argument == "--lsb-first") {
+      options.lsb_first = true;
+    } else if (argument == "--no-chunk-index") {
+      options.chunk_index = false;
+    } else if (!argument.empty() && argument[0] == '-') {
+      return false;
+    } else {
+      positional.push_back(argument);
+    }
+  }
+  if (positional.empty()) {
+    return false;
+  }
+  options.command = positional[0];
+  if (options.command == "info") {
+    if (positional.size() != 2) {
+      return false;
+    }
+    options.input = positional[1];
+    return true;
+  }
+  if ((options.command != "compress" && options.command != "decompress") || positional.size() != 3) {
+    return false;
+  }
+  options.input = positional[1];
+  options.output = positional[2];
+  return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_arguments(argc, argv, options)) {
+    std::cerr << usage;
+    return 2;
+  }
+  if (options.command == "info") {
+    return info(options);
+  }
+  if (options.command == "compress") {
+    return dispatch<CompressCommand>(options.type, options);
+  }
+  MappedFile input;
+  compc::FrameHeader header;
+  if (read_frame(options, input, header) != 0) {
+    return 1;
+  }
+  return dispatch<DecompressCommand>(type_name(header), options, input);
+}
@@ -0,0 +1,299 @@
+#include "compintc/selection.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/elias_factory.hpp"
+#include "compintc/index_stream.hpp"
+
+namespace {
+constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+// exact comparison without the floating point equality warning
+template <typename V> bool same_magnitude(V a, V b) { return !(a > b) && a >= b; }
+
+/*
+  equal_quota: if set, the number of values with a magnitude equal to the threshold each chunk may select,
+    otherwise all of them are selected
+*/
+template <typename V>
+compc::SparseSelection<V> fused_select(const V* values, std::size_t length, V threshold,
+                                       const std::vector<std::size_t>* equal_quota, compc::CodecId codec_id,
+                                       bool keep_values, int num_threads, compc::ThreadBudget* thread_budget) {
+  compc::SparseSelection<V> selection;
+  selection.indices.codec = codec_id;
+  std::unique_ptr<compc::EliasBase<uint64_t>> codec = compc::make_elias<uint64_t>(codec_id);
+  if (codec == nullptr) {
+    return selection;
+  }
+  if (num_threads > 0) {
+    codec->num_threads = num_threads;
+  }
+  codec->thread_budget = thread_budget;
+  compc::ThreadLease lease(codec->thread_budget, codec->num_threads);
+  int local_threads = codec->threads();
+  const std::size_t total_chunks = (length + compc::selection_chunk_size - 1) / compc::selection_chunk_size;
+  if (total_chunks < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(total_chunks), 1);
+  }
+  compc::EliasBase<uint64_t>& kernels = *codec;
+
+  // per chunk: the thread keeping its gaps, where they start in its buffer, and the selection
+  std::vector<int> owner(total_chunks, 0);
+  std::vector<std::size_t> buffer_offset(total_chunks, 0);
+  std::vector<std::size_t> counts(total_chunks, 0);
+  std::vector<std::size_t> first_index(total_chunks, 0);
+  std::vector<std::size_t> last_index(total_chunks, 0);
+  std::vector<std::size_t> bits(total_chunks, 0); // without the first gap until the prefix sum
+  std::vector<std::size_t> start_bits(total_chunks, 0);
+  std::vector<std::size_t> end_bits(total_chunks, 0);
+  std::vector<std::size_t> value_offsets(total_chunks, 0);
+  std::vector<std::vector<uint64_t>> gaps(static_cast<std::size_t>(local_threads));
+  std::vector<std::vector<V>> kept(static_cast<std::size_t>(local_threads));
+  uint8_t* compressed = nullptr;
+  V* selected_values = nullptr;
+
+#pragma omp parallel default(none)                                                                                     \
+    shared(values, equal_quota, kernels, owner, buffer_offset, counts, first_index, last_index, bits, start_bits,      \
+           end_bits, value_offsets, gaps, kept, compressed, selected_values, selection)                                \
+    firstprivate(length, threshold, total_chunks, keep_values) num_threads(local_threads)
+  {
+    const int thread = omp_get_thread_num();
+    std::vector<uint64_t>& thread_gaps = gaps[static_cast<std::size_t>(thread)];
+    std::vector<V>& thread_values = kept[static_cast<std::size_t>(thread)];
+#pragma omp for schedule(static)
+    for (std::size_t c = 0; c < total_chunks; c++) {
+      owner[c] = thread;
+      buffer_offset[c] = thread_gaps.size();
+      std::size_t quota = equal_quota != nullptr ? (*equal_quota)[c] : unlimited;
+      std::size_t end = std::min((c + 1) * compc::selection_chunk_size, length);
+      std::size_t previous = 0;
+      bool first = true;
+      for (std::size_t i = c * compc::selection_chunk_size; i < end; i++) {
+        V magnitude = std::abs(values[i]);
+        bool equal = same_magnitude(magnitude, threshold);
+        if (magnitude > threshold || (equal && quota > 0)) {
+          quota -= equal ? std::size_t{1} : std::size_t{0};
+          // the first gap of a chunk depends on the previous chunks and is filled in later
+          thread_gaps.push_back(first ? 0 : i - previous);
+          first_index[c] = first ? i : first_index[c];
+          first = false;
+          previous = i;
+          if (keep_values) {
+            thread_values.push_back(values[i]);
+          }
+        }
+      }
+      last_index[c] = previous;
+      counts[c] = thread_gaps.size() - buffer_offset[c];
+      bool error = false;
+      if (counts[c] > 1) {
+        bits[c] = kernels.chunk_bit_length(thread_gaps.data(), buffer_offset[c] + 1, thread_gaps.size(), error);
+      }
+    }
+
+#pragma omp single
+    {
+      std::size_t total_bits = 0;
+      std::size_t total_count = 0;
+      bool started = false;
+      std::size_t previous = 0;
+      for (std::size_t c = 0; c < total_chunks; c++) {
+        value_offsets[c] = total_count;
+        start_bits[c] = total_bits;
+        if (counts[c] == 0) {
+          continue;
+        }
+        uint64_t& first_gap = gaps[static_cast<std::size_t>(owner[c])][buffer_offset[c]];
+        first_gap = started ? first_index[c] - previous : first_index[c] + uint64_t{1};
+        bool error = false;
+        total_bits += kernels.chunk_bit_length(&first_gap, 0, 1, error) + bits[c];
+        end_bits[c] = total_bits;
+        total_count += counts[c];
+        started = true;
+        previous = last_index[c];
+      }
+      selection.indices.count = total_count;
+      // zero initialized, the chunks share their boundary bytes
+      selection.indices.data.assign((total_bits + 7) / 8, 0);
+      compressed = selection.indices.data.data();
+      selection.values.resize(keep_values ? total_count : 0);
+      selected_values = selection.values.data();
+    }
+
+#pragma omp for schedule(static)
+    for (std::size_t c = 0; c < total_chunks; c++) {
+      if (counts[c] == 0) {
+        continue;
+      }
+      const auto chunk_owner = static_cast<std::size_t>(owner[c]);
+      kernels.encode_chunk(gaps[chunk_owner].data(), buffer_offset[c], buffer_offset[c] + counts[c], start_bits[c],
+                           end_bits[c], compressed);
+      if (keep_values) {
+        std::copy_n(kept[chunk_owner].begin() + static_cast<std::ptrdiff_t>(buffer_offset[c]), counts[c],
+                    selected_values + value_offsets[c]);
+      }
+    }
+  }
+  return selection;
+}
+
+// the bits of a magnitude, for values >= 0 they are ordered like the values
+template <typename V> using MagnitudeKey = std::conditional_t<sizeof(V) == sizeof(uint32_t), uint32_t, uint64_t>;
+
+template <typename V> MagnitudeKey<V> magnitude_key(V value) {
+  V magnitude = std::abs(value);
+  MagnitudeKey<V> key = 0;
+  std::memcpy(&key, &magnitude, sizeof(key));
+  return key;
+}
+
+// a value that can still be the k-th largest magnitude, and the chunk it is in
+template <typename V> struct TopKCandidate {
+  MagnitudeKey<V> key;
+  std::size_t chunk;
+};
+
+constexpr uint32_t radix_digit_bits = 12;
+
+/*
+  Returns the k-th largest magnitude without copying the array. A radix selection on the bits of the magnitudes
+  narrows the threshold down with a histogram of the next 12 bits per pass, until few enough values share the known
+  high bits. These candidates are gathered in one more pass and the threshold is selected among them. Usually two
+  passes over the array suffice. Also sets how many values equal to the threshold each chunk holds, capped in
+  index order so that exactly k values are selected.
+*/
+template <typename V>
+V top_k_threshold(const V* values, std::size_t length, std::size_t k, int local_threads,
+                  std::vector<std::size_t>& equal_quota) {
+  using Key = MagnitudeKey<V>;
+  constexpr auto key_bits = static_cast<uint32_t>(sizeof(Key) * 8);
+  const std::size_t candidate_limit = std::max<std::size_t>(length / 16, 4096);
+  const std::size_t total_chunks = equal_quota.size();
+  Key prefix = 0;          // the known high bits of the threshold
+  uint32_t known_bits = 0; // number of known bits
+  std::size_t greater = 0; // values above every key with the prefix
+  std::size_t rank = k;    // rank of the threshold among the values with the prefix, 1 is the largest
+  std::size_t in_prefix = length;
+  while (in_prefix > candidate_limit && known_bits < key_bits) {
+    const uint32_t digit_bits = std::min(radix_digit_bits, key_bits - known_bits);
+    const uint32_t shift = key_bits - known_bits - digit_bits;
+    const std::size_t buckets = std::size_t{1} << digit_bits;
+    std::vector<std::size_t> histogram(buckets, 0);
+    Key lowest = std::numeric_limits<Key>::max();
+    Key highest = 0;
+#pragma omp parallel default(none) shared(values, histogram)                                                           \
+    firstprivate(length, prefix, known_bits, shift, buckets, key_bits) reduction(min : lowest)                        \
+    reduction(max : highest) num_threads(local_threads)
+    {
+      std::vector<std::size_t> local(buckets, 0);
+#pragma omp for schedule(static)
+      for (std::size_t i = 0; i < length; i++) {
+        Key key = magnitude_key(values[i]);
+        if (known_bits == 0 || key >> (key_bits - known_bits) == prefix) {
+          local[static_cast<std::size_t>(key >> shift) & (buckets - 1)]++;
+          lowest = std::min(lowest, key);
+          highest = std::max(highest, key);
+        }
+      }
+#pragma omp critical
+      for (std::size_t b = 0; b < buckets; b++) {
+        histogram[b] += local[b];
+      }
+    }
+    std::size_t digit = buckets - 1;
+    while (histogram[digit] < rank) {
+      rank -= histogram[digit];
+      greater += histogram[digit];
+      digit--;
+    }
+    prefix = static_cast<Key>((known_bits == 0 ? Key{0} : static_cast<Key>(prefix << digit_bits)) | digit);
+    known_bits += digit_bits;
+    in_prefix = histogram[digit];
+    if (lowest == highest) {
+      // all remaining values are equal, e.g. many zeros, no need to look at the lower bits
+      prefix = lowest;
+      known_bits = key_bits;
+    }
+  }
+
+  std::vector<std::vector<TopKCandidate<V>>> gathered(static_cast<std::size_t>(local_threads));
+#pragma omp parallel default(none) shared(values, gathered)                                                            \
+    firstprivate(length, prefix, known_bits, key_bits, total_chunks) num_threads(local_threads)
+  {
+    std::vector<TopKCandidate<V>>& local = gathered[static_cast<std::size_t>(omp_get_thread_num())];
+#pragma omp for schedule(static)
+    for (std::size_t c = 0; c < total_chunks; c++) {
+      std::size_t end = std::min((c + 1) * compc::selection_chunk_size, length);
+      for (std::size_t i = c * compc::selection_chunk_size; i < end; i++) {
+        Key key = magnitude_key(values[i]);
+        if (known_bits == 0 || key >> (key_bits - known_bits) == prefix) {
+          local.push_back(TopKCandidate<V>{key, c});
+        }
+      }
+    }
+  }
+  std::vector<TopKCandidate<V>> candidates;
+  for (std::vector<TopKCandidate<V>>& local : gathered) {
+    candidates.insert(candidates.end(), local.begin(), local.end());
+  }
+  auto by_key = [](const TopKCandidate<V>& a, const TopKCandidate<V>& b) { return a.key > b.key; };
+  std::nth_element(candidates.begin(), candidates.begin() + static_cast<std::ptrdiff_t>(rank - 1), candidates.end(),
+                   by_key);
+  const Key threshold_key = candidates[rank - 1].key;
+  for (const TopKCandidate<V>& candidate : candidates) {
+    greater += candidate.key > threshold_key ? std::size_t{1} : std::size_t{0};
+    equal_quota[candidate.chunk] += candidate.key == threshold_key ? std::size_t{1} : std::size_t{0};
+  }
+  std::size_t remaining = k - greater;
+  for (std::size_t& quota : equal_quota) {
+    quota = std::min(quota, remaining);
+    remaining -= quota;
+  }
+  V threshold{};
+  std::memcpy(&threshold, &threshold_key, sizeof(threshold));
+  return threshold;
+}
+} // namespace
+
+template <typename V>
+compc::SparseSelection<V> compc::select_threshold(const V* values, std::size_t length, V threshold, CodecId codec,
+                                                  bool keep_values, int num_threads, ThreadBudget* thread_budget) {
+  return fused_select<V>(values, length, threshold, nullptr, codec, keep_values, num_threads, thread_budget);
+}
+
+template <typename V>
+compc::SparseSelection<V> compc::select_top_k(const V* values, std::size_t length, std::size_t k, CodecId codec,
+                                              bool keep_values, int num_threads, ThreadBudget* thread_budget) {
+  k = std::min(k, length);
+  if (k == 0) {
+    return fused_select<V>(values, 0, V{0}, nullptr, codec, keep_values, num_threads, thread_budget);
+  }
+  if (num_threads <= 0) {
+    num_threads = default_num_threads();
+  }
+  // one lease for both passes, the one of fused_select is nested and leases nothing
+  ThreadLease lease(thread_budget, num_threads);
+  const std::size_t total_chunks = (length + selection_chunk_size - 1) / selection_chunk_size;
+  std::vector<std::size_t> equal_quota(total_chunks, 0);
+  const V threshold = top_k_threshold(values, length, k, ThreadLease::limit(num_threads), equal_quota);
+  return fused_select<V>(values, length, threshold, &equal_quota, codec, keep_values, num_threads, thread_budget);
+}
+
+template compc::SparseSelection<float> compc::select_threshold<float>(const float*, std::size_t, float, CodecId, bool,
+                                                                      int, ThreadBudget*);
+template compc::SparseSelection<double> compc::select_threshold<double>(const double*, std::size_t, double, CodecId,
+                                                                         bool, int, ThreadBudget*);
+template compc::SparseSelection<float> compc::select_top_k<float>(const float*, std::size_t, std::size_t, CodecId, bool,
+                                                                  int, ThreadBudget*);
+template compc::SparseSelection<double> compc::select_top_k<double>(const double*, std::size_t, std::size_t, CodecId,
+                                                                    bool, int, ThreadBudget*);
@@ -0,0 +1,109 @@
+#include "compintc/session.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "compintc/index_stream.hpp"
+
+template <typename T>
+std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode(const T* indices, std::size_t length) {
+  std::unique_ptr<compc::GapStream> next = compc::encode_gap_stream<T>(indices, length, codec);
+  if (next == nullptr) {
+    return nullptr;
+  }
+  // one merge of the new indices with the decoded previous set
+  compc::GapStreamWriter insertions(codec);
+  compc::GapStreamWriter deletions(codec);
+  compc::GapStreamReader reader(previous);
+  uint64_t old_index = 0;
+  bool has_old = reader.next(old_index);
+  for (std::size_t i = 0; i < length; i++) {
+    auto index = static_cast<uint64_t>(indices[i]);
+    while (has_old && old_index < index) {
+      deletions.push(old_index);
+      has_old = reader.next(old_index);
+    }
+    if (has_old && old_index == index) {
+      has_old = reader.next(old_index);
+    } else {
+      insertions.push(index);
+    }
+  }
+  while (has_old) {
+    deletions.push(old_index);
+    has_old = reader.next(old_index);
+  }
+  std::unique_ptr<compc::GapStream> inserted = insertions.finish();
+  std::unique_ptr<compc::GapStream> deleted = deletions.finish();
+  if (!reader.valid() || inserted == nullptr || deleted == nullptr) {
+    return nullptr;
+  }
+
+  auto delta = std::make_unique<compc::SessionDelta>();
+  delta->round = ++rounds;
+  if (force_keyframe || inserted->data.size() + deleted->data.size() >= next->data.size()) {
+    delta->keyframe = true;
+    delta->insertions = *next;
+    delta->deletions.codec = codec;
+  } else {
+    delta->insertions = std::move(*inserted);
+    delta->deletions = std::move(*deleted);
+  }
+  force_keyframe = false;
+  previous = std::move(*next);
+  return delta;
+}
+
+bool compc::SessionDecoder::apply(const SessionDelta& delta) {
+  if (delta.keyframe ? delta.round <= rounds : delta.round != rounds + 1) {
+    return false;
+  }
+  // merges the previous set with the insertions and drops the deletions
+  const compc::GapStream empty{};
+  compc::GapStreamReader old_reader(delta.keyframe ? empty : current);
+  compc::GapStreamReader inserted_reader(delta.insertions);
+  compc::GapStreamReader deleted_reader(delta.deletions);
+  compc::GapStreamWriter writer(codec);
+  uint64_t old_index = 0;
+  uint64_t inserted = 0;
+  uint64_t deleted = 0;
+  bool has_old = old_reader.next(old_index);
+  bool has_inserted = inserted_reader.next(inserted);
+  bool has_deleted = deleted_reader.next(deleted);
+  while (has_old || has_inserted) {
+    if (has_old && (!has_inserted || old_index < inserted)) {
+      if (has_deleted && deleted < old_index) {
+        return false; // deletes an index that is not in the set
+      }
+      if (has_deleted && deleted == old_index) {
+        has_deleted = deleted_reader.next(deleted);
+      } else {
+        writer.push(old_index);
+      }
+      has_old = old_reader.next(old_index);
+    } else if (has_inserted && (!has_old || inserted < old_index)) {
+      writer.push(inserted);
+      has_inserted = inserted_reader.next(inserted);
+    } else {
+      return false; // inserts an index that is already in the set
+    }
+  }
+  if (has_deleted || !old_reader.valid() || !inserted_reader.valid() || !deleted_reader.valid()) {
+    return false;
+  }
+  std::unique_ptr<compc::GapStream> next = writer.finish();
+  if (next == nullptr) {
+    return false;
+  }
+  current = std::move(*next);
+  rounds = delta.round;
+  return true;
+}
+
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<int16_t>(const int16_t*, std::size_t);
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<uint16_t>(const uint16_t*, std::size_t);
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<int32_t>(const int32_t*, std::size_t);
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<uint32_t>(const uint32_t*, std::size_t);
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<int64_t>(const int64_t*, std::size_t);
+template std::unique_ptr<compc::SessionDelta> compc::SessionEncoder::encode<uint64_t>(const uint64_t*, std::size_t);
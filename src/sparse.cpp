@@ -0,0 +1,229 @@
+#include "compintc/sparse.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include "compintc/elias_base.hpp"
+#include "compintc/thread_budget.hpp"
+
+namespace {
+template <typename T> int threads_for(const compc::EliasBase<T>& codec, std::size_t work_items) {
+  int local_threads = codec.threads();
+  if (work_items < static_cast<std::size_t>(local_threads)) {
+    local_threads = std::max(static_cast<int>(work_items), 1);
+  }
+  return local_threads;
+}
+
+template <typename T> bool is_negative(T value) {
+  if constexpr (std::is_signed_v<T>) {
+    return value < 0;
+  } else {
+    return false;
+  }
+}
+} // namespace
+
+template <typename T>
+compc::CompressedCsr compc::compress_csr(EliasBase<T>& codec, const T* row_ptr, const T* col_idx, std::size_t rows) {
+  compc::ThreadLease lease(codec.thread_budget, codec.num_threads);
+  compc::CompressedCsr compressed;
+  compressed.rows = rows;
+  for (std::size_t r = 0; r < rows; r++) {
+    if (row_ptr[r + 1] < row_ptr[r] || row_ptr[r + 1] - row_ptr[r] == std::numeric_limits<T>::max()) {
+      return compc::CompressedCsr{};
+    }
+  }
+  const std::size_t nnz = static_cast<std::size_t>(row_ptr[rows] - row_ptr[0]);
+  compressed.nnz = nnz;
+  const T* columns = col_idx + static_cast<std::size_t>(row_ptr[0]);
+
+  // blocks of whole rows with about batch_size_large numbers each
+  const std::size_t target = std::max<std::size_t>(codec.batch_size_large, 1);
+  compressed.block_rows.push_back(0);
+  compressed.block_nnz.push_back(0);
+  std::size_t block_values = 0;
+  for (std::size_t r = 0; r < rows; r++) {
+    block_values += 1 + static_cast<std::size_t>(row_ptr[r + 1] - row_ptr[r]);
+    if (block_values >= target && r + 1 < rows) {
+      compressed.block_rows.push_back(r + 1);
+      compressed.block_nnz.push_back(static_cast<std::size_t>(row_ptr[r + 1] - row_ptr[0]));
+      block_values = 0;
+    }
+  }
+  const std::size_t blocks = rows == 0 ? 0 : compressed.block_rows.size();
+  compressed.block_rows.resize(blocks);
+  compressed.block_nnz.resize(blocks);
+  const int local_threads = threads_for(codec, blocks);
+
+  // the stream of counts and gaps, the numbers of block b start at block_rows[b] + block_nnz[b]
+  std::unique_ptr<T[]> stream(new T[rows + nnz + 1]);
+  T* stream_ptr = stream.get();
+  bool error = false;
+#pragma omp parallel for schedule(dynamic, 1024) default(none) shared(row_ptr, columns, stream_ptr)                   \
+    reduction(|| : error) firstprivate(rows) num_threads(local_threads)
+  for (std::size_t r = 0; r < rows; r++) {
+    std::size_t start = static_cast<std::size_t>(row_ptr[r] - row_ptr[0]);
+    std::size_t end = static_cast<std::size_t>(row_ptr[r + 1] - row_ptr[0]);
+    T* out = stream_ptr + r + start;
+    out[0] = static_cast<T>(end - start + 1);
+    for (std::size_t i = start; i < end; i++) {
+      T gap = 0;
+      if (i == start) {
+        error = error || is_negative(columns[i]) || columns[i] == std::numeric_limits<T>::max();
+        gap = static_cast<T>(columns[i] + 1);
+      } else {
+        error = error || columns[i] <= columns[i - 1];
+        gap = static_cast<T>(columns[i] - columns[i - 1]);
+      }
+      out[1 + i - start] = gap;
+    }
+  }
+  if (error) {
+    return compc::CompressedCsr{};
+  }
+
+  std::vector<std::size_t>& end_bits = compressed.block_end_bits;
+  end_bits.assign(blocks, 0);
+  const std::vector<std::size_t>& block_rows = compressed.block_rows;
+  const std::vector<std::size_t>& block_nnz = compressed.block_nnz;
+  auto block_start = [&](std::size_t b) { return b < blocks ? block_rows[b] + block_nnz[b] : rows + nnz; };
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(codec, stream_ptr, end_bits, block_start)         \
+    reduction(|| : error) firstprivate(blocks) num_threads(local_threads)
+  for (std::size_t b = 0; b < blocks; b++) {
+    bool error_local = false;
+    end_bits[b] = codec.chunk_bit_length(stream_ptr, block_start(b), block_start(b + 1), error_local);
+    error = error || error_local;
+  }
+  if (error) {
+    return compc::CompressedCsr{};
+  }
+  std::partial_sum(end_bits.begin(), end_bits.end(), end_bits.begin());
+  compressed.payload_bytes = blocks == 0 ? 0 : (end_bits[blocks - 1] + 7) / 8;
+  // zero initialize, otherwise there are problems at the edges of the blocks
+  compressed.payload = std::make_unique<uint8_t[]>(std::max<std::size_t>(compressed.payload_bytes, 1));
+  uint8_t* payload = compressed.payload.get();
+#pragma omp parallel for schedule(dynamic, 1) default(none) shared(codec, stream_ptr, end_bits, block_start, payload) \
+    firstprivate(blocks) num_threads(local_threads)
+  for (std::size_t b = 0; b < blocks; b++) {
+    std::size_t start_bit = b == 0 ? 0 : end_bits[b - 1];
+    codec.encode_chunk(stream_ptr, block_start(b), block_start(b + 1), start_bit, end_bits[b], payload);
+  }
+  return compressed;
+}
+
+template <typename T> compc::CsrMatrix<T> compc::decompress_csr(EliasBase<T>& codec, const CompressedCsr& compressed) {
+  compc::ThreadLease lease(codec.thread_budget, codec.num_threads);
+  const std::size_t rows = compressed.rows;
+  const std::size_t nnz = compressed.nnz;
+  const std::size_t blocks = compressed.block_rows.size();
+  if (compressed.block_nnz.size() != blocks || compressed.block_end_bits.size() != blocks ||
+      (blocks > 0 && compressed.block_end_bits[blocks - 1] > compressed.payload_bytes * 8)) {
+    return compc::CsrMatrix<T>{};
+  }
+  compc::CsrMatrix<T> matrix{rows, nnz, std::unique_ptr<T[]>(new T[rows + 1]),
+                             std::unique_ptr<T[]>(new T[std::max<std::size_t>(nnz, 1)])};
+  T* row_ptr = matrix.row_ptr.get();
+  T* col_idx = matrix.col_idx.get();
+  row_ptr[0] = 0;
+  const uint8_t* payload = compressed.payload.get();
+  const std::size_t payload_bytes = compressed.payload_bytes;
+  const std::vector<std::size_t>& block_rows = compressed.block_rows;
+  const std::vector<std::size_t>& block_nnz = compressed.block_nnz;
+  const std::vector<std::size_t>& end_bits = compressed.block_end_bits;
+  bool error = false;
+#pragma omp parallel default(none) shared(codec, payload, block_rows, block_nnz, end_bits, row_ptr, col_idx)         \
+    reduction(|| : error) firstprivate(blocks, rows, nnz, payload_bytes)                              \
+    num_threads(threads_for(codec, blocks))
+  {
+    std::vector<T> scratch;
+#pragma omp for schedule(dynamic, 1)
+    for (std::size_t b = 0; b < blocks; b++) {
+      std::size_t row_end = b + 1 < blocks ? block_rows[b + 1] : rows;
+      std::size_t nnz_end = b + 1 < blocks ? block_nnz[b + 1] : nnz;
+      std::size_t count = (row_end - block_rows[b]) + (nnz_end - block_nnz[b]);
+      scratch.resize(count);
+      codec.decode_chunk(payload, payload_bytes, b == 0 ? 0 : end_bits[b - 1], scratch.data(), count);
+      std::size_t position = 0;
+      std::size_t column_position = block_nnz[b];
+      for (std::size_t r = block_rows[b]; r < row_end && !error; r++) {
+        auto row_nnz = static_cast<std::size_t>(scratch[position++] - 1);
+        if (row_nnz > nnz_end - column_position || position + row_nnz > count) {
+          error = true;
+          break;
+        }
+        T column = static_cast<T>(-1);
+        for (std::size_t i = 0; i < row_nnz; i++) {
+          column = static_cast<T>(column + scratch[position++]);
+          col_idx[column_position++] = column;
+        }
+        row_ptr[r + 1] = static_cast<T>(column_position);
+      }
+      error = error || column_position != nnz_end;
+    }
+  }
+  if (error) {
+    return compc::CsrMatrix<T>{};
+  }
+  return matrix;
+}
+
+template <typename T>
+compc::CsrMatrix<T> compc::coo_to_csr(const T* row_idx, const T* col_idx, std::size_t nnz, std::size_t rows) {
+  compc::CsrMatrix<T> matrix{rows, nnz, std::make_unique<T[]>(rows + 1),
+                             std::unique_ptr<T[]>(new T[std::max<std::size_t>(nnz, 1)])};
+  std::vector<std::size_t> order(nnz);
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    return row_idx[a] < row_idx[b] || (row_idx[a] == row_idx[b] && col_idx[a] < col_idx[b]);
+  });
+  T* row_ptr = matrix.row_ptr.get();
+  for (std::size_t i = 0; i < nnz; i++) {
+    row_ptr[static_cast<std::size_t>(row_idx[i]) + 1]++;
+    matrix.col_idx[i] = col_idx[order[i]];
+  }
+  for (std::size_t r = 0; r < rows; r++) {
+    row_ptr[r + 1] = static_cast<T>(row_ptr[r + 1] + row_ptr[r]);
+  }
+  return matrix;
+}
+
+template compc::CompressedCsr compc::compress_csr<int16_t>(EliasBase<int16_t>&, const int16_t*, const int16_t*,
+                                                           std::size_t);
+template compc::CompressedCsr compc::compress_csr<uint16_t>(EliasBase<uint16_t>&, const uint16_t*, const uint16_t*,
+                                                            std::size_t);
+template compc::CompressedCsr compc::compress_csr<int32_t>(EliasBase<int32_t>&, const int32_t*, const int32_t*,
+                                                           std::size_t);
+template compc::CompressedCsr compc::compress_csr<uint32_t>(EliasBase<uint32_t>&, const uint32_t*, const uint32_t*,
+                                                            std::size_t);
+template compc::CompressedCsr compc::compress_csr<int64_t>(EliasBase<int64_t>&, const int64_t*, const int64_t*,
+                                                           std::size_t);
+template compc::CompressedCsr compc::compress_csr<uint64_t>(EliasBase<uint64_t>&, const uint64_t*, const uint64_t*,
+                                                            std::size_t);
+
+template compc::CsrMatrix<int16_t> compc::decompress_csr<int16_t>(EliasBase<int16_t>&, const CompressedCsr&);
+template compc::CsrMatrix<uint16_t> compc::decompress_csr<uint16_t>(EliasBase<uint16_t>&, const CompressedCsr&);
+template compc::CsrMatrix<int32_t> compc::decompress_csr<int32_t>(EliasBase<int32_t>&, const CompressedCsr&);
+template compc::CsrMatrix<uint32_t> compc::decompress_csr<uint32_t>(EliasBase<uint32_t>&, const CompressedCsr&);
+template compc::CsrMatrix<int64_t> compc::decompress_csr<int64_t>(EliasBase<int64_t>&, const CompressedCsr&);
+template compc::CsrMatrix<uint64_t> compc::decompress_csr<uint64_t>(EliasBase<uint64_t>&, const CompressedCsr&);
+
+template compc::CsrMatrix<int16_t> compc::coo_to_csr<int16_t>(const int16_t*, const int16_t*, std::size_t,
+                                                              std::size_t);
+template compc::CsrMatrix<uint16_t> compc::coo_to_csr<uint16_t>(const uint16_t*, const uint16_t*, std::size_t,
+                                                                std::size_t);
+template compc::CsrMatrix<int32_t> compc::coo_to_csr<int32_t>(const int32_t*, const int32_t*, std::size_t,
+                                                              std::size_t);
+template compc::CsrMatrix<uint32_t> compc::coo_to_csr<uint32_t>(const uint32_t*, const uint32_t*, std::size_t,
+                                                                std::size_t);
+template compc::CsrMatrix<int64_t> compc::coo_to_csr<int64_t>(const int64_t*, const int64_t*, std::size_t,
+                                                              std::size_t);
+template compc::CsrMatrix<uint64_t> compc::coo_to_csr<uint64_t>(const uint64_t*, const uint64_t*, std::size_t,
+                                                                std::size_t);
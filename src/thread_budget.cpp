@@ -0,0 +1,61 @@
+#include "compintc/thread_budget.hpp"
+
+#include <omp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace {
+// threads of the lease alive on this thread, 0 if there is none
+thread_local int leased_threads = 0;
+} // namespace
+
+compc::ThreadBudget::ThreadBudget(int threads) {
+  total = threads > 0 ? threads : static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+  free.store(total, std::memory_order_relaxed);
+}
+
+compc::ThreadBudget& compc::ThreadBudget::process() {
+  static ThreadBudget budget;
+  return budget;
+}
+
+int compc::ThreadBudget::acquire(int wanted) {
+  int current = free.load(std::memory_order_relaxed);
+  int taken = 0;
+  do {
+    taken = std::clamp(wanted, 0, current);
+  } while (taken > 0 && !free.compare_exchange_weak(current, current - taken, std::memory_order_acq_rel));
+  return taken;
+}
+
+void compc::ThreadBudget::release(int threads) {
+  if (threads > 0) {
+    free.fetch_add(threads, std::memory_order_acq_rel);
+  }
+}
+
+compc::ThreadLease::ThreadLease(ThreadBudget* budget, int wanted) {
+  if (budget == nullptr || leased_threads != 0 || omp_in_parallel() != 0) {
+    return;
+  }
+  owner = budget;
+  taken = budget->acquire(wanted);
+  // the calling thread can always be used
+  leased_threads = std::max(taken, 1);
+}
+
+compc::ThreadLease::~ThreadLease() {
+  if (owner != nullptr) {
+    owner->release(taken);
+    leased_threads = 0;
+  }
+}
+
+int compc::ThreadLease::limit(int wanted) {
+  if (omp_in_parallel() != 0) {
+    return 1;
+  }
+  return leased_threads != 0 ? std::min(wanted, leased_threads) : wanted;
+}
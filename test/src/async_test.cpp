@@ -0,0 +1,128 @@
+#include "compintc/async.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "helpers.hpp"
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <gtest/gtest.h>
+#include <new>
+#include <vector>
+
+// a codec whose allocations always fail
+struct FailingCodec {
+  int num_threads = 1;
+  std::unique_ptr<uint8_t[]> compress(const long*, std::size_t&) { throw std::bad_alloc(); }
+  std::unique_ptr<long[]> decompress(const uint8_t*, std::size_t, std::size_t) { throw std::bad_alloc(); }
+};
+
+TEST(Async_Futures, CheckValues) {
+  compc::AsyncExecutor executor(4, 2);
+  ASSERT_EQ(executor.threads_per_operation(), 2);
+  std::size_t len = 100000;
+  std::vector<std::unique_ptr<long[]>> inputs;
+  std::vector<std::future<compc::CompressedBuffer>> futures;
+  compc::EliasDelta<long> elias;
+  for (int layer = 0; layer < 6; layer++) {
+    inputs.push_back(compc_test::get_random_array<long>(len));
+    futures.push_back(executor.compress_async(elias, inputs.back().get(), len));
+  }
+  for (std::size_t layer = 0; layer < futures.size(); layer++) {
+    compc::CompressedBuffer buffer = futures[layer].get();
+    ASSERT_NE(buffer.data, nullptr);
+    std::size_t expected_size = len;
+    elias.compress(inputs[layer].get(), expected_size);
+    ASSERT_EQ(buffer.size, expected_size);
+    std::unique_ptr<long[]> output =
+        executor.decompress_async<compc::EliasDelta<long>, long>(elias, buffer.data.get(), buffer.size, len).get();
+    for (std::size_t i = 0; i < len; i++) {
+      ASSERT_EQ(output[i], inputs[layer][i]); // comparing values
+    }
+  }
+}
+
+TEST(Async_Callbacks, CheckValues) {
+  std::atomic<int> completed{0};
+  std::atomic<int> invalid{0};
+  std::size_t len = 10000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  random_array[5] = 0; // not encodable without an offset
+  {
+    compc::AsyncExecutor executor(2, 4);
+    compc::EliasGamma<long> elias;
+    compc::EliasGamma<long> shifted{1, false};
+    for (int i = 0; i < 8; i++) {
+      executor.compress_async(i % 2 == 0 ? elias : shifted, random_array.get(), len,
+                              [&](compc::CompressedBuffer buffer) {
+                                if (buffer.data == nullptr) {
+                                  invalid++;
+                                }
+                                completed++;
+                              });
+    }
+    executor.wait_idle();
+    ASSERT_EQ(completed.load(), 8);
+    executor.compress_async(shifted, random_array.get(), len, [&](compc::CompressedBuffer) { completed++; });
+  } // the destructor completes the queued operation
+  ASSERT_EQ(completed.load(), 9);
+  ASSERT_EQ(invalid.load(), 4);
+}
+
+TEST(Async_SharedBudget, CheckValues) {
+  compc::ThreadBudget budget(4);
+  compc::AsyncExecutor executor(budget, 2);
+  ASSERT_EQ(&executor.budget(), &budget);
+  ASSERT_EQ(executor.threads_per_operation(), 2);
+  std::size_t len = 20000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  std::atomic<int> limit{0};
+  std::atomic<int> available{0};
+  auto record = [&](compc::CompressedBuffer) {
+    limit = compc::ThreadLease::limit(8);
+    available = budget.available();
+  };
+  executor.compress_async(elias, random_array.get(), len, record);
+  executor.wait_idle();
+  ASSERT_EQ(limit.load(), 2);
+  ASSERT_EQ(available.load(), 2);
+  {
+    // another user of the budget holds three threads, the operation gets the last one
+    compc::ThreadLease other(&budget, 3);
+    executor.compress_async(elias, random_array.get(), len, record);
+    executor.wait_idle();
+    ASSERT_EQ(limit.load(), 1);
+    ASSERT_EQ(available.load(), 0);
+  }
+  ASSERT_EQ(budget.available(), 4);
+}
+
+TEST(Async_Exceptions, CheckValues) {
+  compc::AsyncExecutor executor(2, 1);
+  long input[3] = {1, 2, 3};
+  uint8_t compressed[4] = {0, 0, 0, 0};
+  std::future<compc::CompressedBuffer> compressed_future = executor.compress_async(FailingCodec{}, input, 3);
+  ASSERT_THROW(compressed_future.get(), std::bad_alloc);
+  std::future<std::unique_ptr<long[]>> decompressed_future =
+      executor.decompress_async<FailingCodec, long>(FailingCodec{}, compressed, 4, 3);
+  ASSERT_THROW(decompressed_future.get(), std::bad_alloc);
+  std::atomic<int> failed{0};
+  executor.compress_async(FailingCodec{}, input, 3, [&](compc::CompressedBuffer buffer) {
+    failed += buffer.data == nullptr ? 1 : 0;
+  });
+  executor.decompress_async<FailingCodec, long>(FailingCodec{}, compressed, 4, 3, [&](std::unique_ptr<long[]> output) {
+    failed += output == nullptr ? 1 : 0;
+  });
+  // a throwing callback does not end the only worker
+  executor.compress_async(FailingCodec{}, input, 3, [](compc::CompressedBuffer) { throw std::bad_alloc(); });
+  executor.wait_idle();
+  ASSERT_EQ(failed.load(), 2);
+  compc::EliasGamma<long> elias;
+  compc::CompressedBuffer buffer = executor.compress_async(elias, input, 3).get();
+  ASSERT_NE(buffer.data, nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
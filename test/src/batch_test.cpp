@@ -0,0 +1,90 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Codec> void check_batch_round_trip(Codec& elias) {
+  // many small layers, an empty one and one large enough for the large batch size
+  std::vector<std::size_t> lengths = {1, 17, 0, 300, 49, 50, 51, 5000, 3, 120000};
+  std::vector<std::unique_ptr<long[]>> inputs;
+  std::vector<const long*> arrays;
+  for (std::size_t length : lengths) {
+    inputs.push_back(compc_test::get_random_array<long>(length));
+    arrays.push_back(inputs.back().get());
+  }
+  compc::CompressedBatch batch = elias.compress_batch(arrays, lengths);
+  ASSERT_NE(batch.data, nullptr);
+  ASSERT_EQ(batch.byte_offsets.size(), lengths.size() + 1);
+  ASSERT_EQ(batch.byte_offsets[2], batch.byte_offsets[3]); // the empty array takes no space
+
+  // every array can be decoded on its own with the regular decompress
+  for (std::size_t a = 0; a < lengths.size(); a++) {
+    if (lengths[a] == 0) {
+      continue;
+    }
+    std::unique_ptr<long[]> single = elias.decompress(batch.data.get() + batch.byte_offsets[a],
+                                                      batch.byte_offsets[a + 1] - batch.byte_offsets[a], lengths[a]);
+    for (std::size_t i = 0; i < lengths[a]; i++) {
+      ASSERT_EQ(single[i], inputs[a][i]);
+    }
+  }
+
+  std::unique_ptr<long[]> output = elias.decompress_batch(batch);
+  std::size_t position = 0;
+  for (std::size_t a = 0; a < lengths.size(); a++) {
+    for (std::size_t i = 0; i < lengths[a]; i++) {
+      ASSERT_EQ(output[position++], inputs[a][i]); // comparing values
+    }
+  }
+}
+
+TEST(Batch_RoundTripGamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  check_batch_round_trip(elias);
+}
+
+TEST(Batch_RoundTripDelta, CheckValues) {
+  compc::EliasDelta<long> elias;
+  elias.num_threads = 4;
+  check_batch_round_trip(elias);
+}
+
+TEST(Batch_RoundTripOmega, CheckValues) {
+  compc::EliasOmega<long> elias;
+  elias.num_threads = 4;
+  check_batch_round_trip(elias);
+}
+
+TEST(Batch_Transforms, CheckValues) {
+  int32_t first[4] = {0, -3, 2000, 2};
+  int32_t second[6] = {-50, 1, 25345, -11, 1000000, 0};
+  compc::EliasGamma<int32_t> elias{1, true};
+  compc::CompressedBatch batch = elias.compress_batch({first, second}, {4, 6});
+  ASSERT_NE(batch.data, nullptr);
+  std::unique_ptr<int32_t[]> output = elias.decompress_batch(batch);
+  for (std::size_t i = 0; i < 4; i++) {
+    ASSERT_EQ(output[i], first[i]);
+  }
+  for (std::size_t i = 0; i < 6; i++) {
+    ASSERT_EQ(output[4 + i], second[i]);
+  }
+  // the inputs are not modified
+  ASSERT_EQ(first[1], -3);
+}
+
+TEST(Batch_InvalidInput, CheckValues) {
+  uint32_t first[3] = {1, 2, 3};
+  uint32_t second[3] = {4, 0, 6};
+  compc::EliasDelta<uint32_t> elias;
+  compc::CompressedBatch batch = elias.compress_batch({first, second}, {3, 3});
+  ASSERT_EQ(batch.data, nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
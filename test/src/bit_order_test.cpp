@@ -0,0 +1,155 @@
+#include "compintc/container.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+template <typename Codec, typename T> void check_bit_order(Codec& elias, const T* input, std::size_t len) {
+  elias.bit_order = compc::BitOrder::msb_first;
+  std::size_t msb_size = len;
+  std::unique_ptr<uint8_t[]> msb = elias.compress(input, msb_size);
+  elias.bit_order = compc::BitOrder::lsb_first;
+  std::size_t small_size = len;
+  std::unique_ptr<uint8_t[]> small = elias.compress(input, small_size);
+  std::size_t threshold = elias.small_message_threshold;
+  elias.small_message_threshold = 0;
+  std::size_t parallel_size = len;
+  std::unique_ptr<uint8_t[]> parallel = elias.compress(input, parallel_size);
+  std::unique_ptr<T[]> parallel_output = elias.decompress(parallel.get(), parallel_size, len);
+  elias.single_pass = true;
+  std::size_t single_pass_size = len;
+  std::unique_ptr<uint8_t[]> single_pass = elias.compress(input, single_pass_size);
+  elias.single_pass = false;
+  elias.small_message_threshold = threshold;
+  // both orders have the same length, and all paths write the same stream
+  ASSERT_EQ(small_size, msb_size);
+  ASSERT_EQ(parallel_size, msb_size);
+  ASSERT_EQ(single_pass_size, msb_size);
+  ASSERT_EQ(std::memcmp(small.get(), parallel.get(), parallel_size), 0);
+  ASSERT_EQ(std::memcmp(single_pass.get(), parallel.get(), parallel_size), 0);
+  std::unique_ptr<T[]> output = elias.decompress(small.get(), small_size, len);
+  std::unique_ptr<T[]> speculative = elias.decompress_speculative(parallel.get(), parallel_size, len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+    ASSERT_EQ(parallel_output[i], input[i]);
+    ASSERT_EQ(speculative[i], input[i]);
+  }
+}
+
+TEST(BitOrder_Gamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 3;
+  for (std::size_t len : {1UL, 300UL, 5000UL, 100000UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    check_bit_order(elias, random_array.get(), len);
+  }
+}
+
+TEST(BitOrder_Delta, CheckValues) {
+  compc::EliasDelta<long> elias{3, true};
+  elias.num_threads = 2;
+  for (std::size_t len : {2UL, 4095UL, 70000UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    random_array[len / 2] = -17;
+    check_bit_order(elias, random_array.get(), len);
+  }
+}
+
+TEST(BitOrder_Omega, CheckValues) {
+  compc::EliasOmega<long> elias{0, true};
+  elias.num_threads = 2;
+  for (std::size_t len : {7UL, 50000UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    check_bit_order(elias, random_array.get(), len);
+  }
+}
+
+TEST(BitOrder_WideValues, CheckValues) {
+  std::vector<uint64_t> input = {1, 2, 3, (1ULL << 32U) - 1, 1ULL << 32U, (1ULL << 56U) + 3, (1ULL << 63U) + 12345,
+                                 std::numeric_limits<uint64_t>::max()};
+  compc::EliasGamma<uint64_t> gamma;
+  check_bit_order(gamma, input.data(), input.size());
+  compc::EliasDelta<uint64_t> delta;
+  check_bit_order(delta, input.data(), input.size());
+  compc::EliasOmega<uint64_t> omega;
+  check_bit_order(omega, input.data(), input.size());
+}
+
+TEST(BitOrder_Layout, CheckValues) {
+  // gamma codes of 1, 2 and 5: 1 | 0 1 0 | 0 0 1 1 0, the binary parts after the leading 1 start with their low bit
+  uint32_t input[3] = {1, 2, 5};
+  compc::EliasGamma<uint32_t> elias;
+  elias.bit_order = compc::BitOrder::lsb_first;
+  std::size_t size = 3;
+  std::unique_ptr<uint8_t[]> comp = elias.compress(input, size);
+  ASSERT_EQ(size, 2);
+  ASSERT_EQ(comp[0], 0xC5);
+  ASSERT_EQ(comp[1], 0x00);
+}
+
+TEST(BitOrder_CopyAndFrames, CheckValues) {
+  std::size_t len = 60000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::EliasDelta<long> elias{1, true};
+  elias.num_threads = 3;
+  elias.bit_order = compc::BitOrder::lsb_first;
+  compc::EliasDelta<long> copy(elias);
+  ASSERT_EQ(copy.bit_order, compc::BitOrder::lsb_first);
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed(copy, random_array.get(), size, true, true);
+  compc::FrameHeader header;
+  ASSERT_TRUE(compc::read_frame_header(frame.get(), size, header));
+  ASSERT_EQ(header.bit_order, compc::BitOrder::lsb_first);
+  ASSERT_TRUE(compc::verify_frame(frame.get(), size));
+  std::size_t array_length = 0;
+  std::unique_ptr<long[]> output = compc::decompress_auto<long>(frame.get(), size, array_length, 2);
+  ASSERT_EQ(array_length, len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+  // flipping the last bit of the payload breaks the checksum of the last chunk only
+  frame[size - 1] ^= 0x01U;
+  std::vector<std::size_t> corrupt{};
+  ASSERT_FALSE(compc::verify_frame(frame.get(), size, &corrupt));
+  ASSERT_EQ(corrupt.size(), 1);
+  ASSERT_EQ(corrupt[0], header.chunk_count - 1);
+  // the lanes are MSB-first only
+  std::size_t lanes_size = len;
+  ASSERT_EQ(elias.compress_lanes(random_array.get(), lanes_size, 8), nullptr);
+}
+
+TEST(BitOrder_BatchAndSegments, CheckValues) {
+  std::vector<std::unique_ptr<long[]>> arrays;
+  std::vector<const long*> inputs;
+  std::vector<std::size_t> lengths = {1000, 1, 33333};
+  for (std::size_t len : lengths) {
+    arrays.push_back(compc_test::get_random_array<long>(len));
+    inputs.push_back(arrays.back().get());
+  }
+  compc::EliasOmega<long> elias{0, true};
+  elias.num_threads = 2;
+  elias.bit_order = compc::BitOrder::lsb_first;
+  compc::CompressedBatch batch = elias.compress_batch(inputs, lengths);
+  std::unique_ptr<long[]> batch_output = elias.decompress_batch(batch);
+  std::size_t position = 0;
+  for (std::size_t a = 0; a < lengths.size(); a++) {
+    for (std::size_t i = 0; i < lengths[a]; i++) {
+      ASSERT_EQ(batch_output[position++], inputs[a][i]); // comparing values
+    }
+  }
+  compc::SegmentedOutput segmented = elias.compress_segments(inputs[2], lengths[2], 4);
+  std::unique_ptr<long[]> segment_output = elias.decompress_segments(segmented.segments);
+  for (std::size_t i = 0; i < lengths[2]; i++) {
+    ASSERT_EQ(segment_output[i], inputs[2][i]); // comparing values
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,150 @@
+#include "compintc/buffer_cache.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
+TEST(BufferCache_HitsAndMisses, CheckValues) {
+  std::size_t len = 5000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::BufferCache cache(1 << 20);
+  compc::EliasGamma<long> elias{1, true};
+  compc::CachedBuffer first = cache.compress(elias, random_array.get(), len);
+  compc::CachedBuffer second = cache.compress(elias, random_array.get(), len);
+  ASSERT_NE(first, nullptr);
+  // the same bytes are shared, not compressed again
+  ASSERT_EQ(first.get(), second.get());
+  ASSERT_EQ(first->values, len);
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> expected = elias.compress(random_array.get(), size);
+  ASSERT_EQ(first->size, size);
+  ASSERT_EQ(std::memcmp(first->data.get(), expected.get(), size), 0);
+  std::unique_ptr<long[]> output = elias.decompress(first->data.get(), first->size, first->values);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+  // the same values as a copy hit too
+  std::vector<long> copy(random_array.get(), random_array.get() + len);
+  ASSERT_EQ(cache.compress(elias, copy.data(), len).get(), first.get());
+  compc::BufferCacheStats stats = cache.stats();
+  ASSERT_EQ(stats.hits, 2);
+  ASSERT_EQ(stats.misses, 1);
+  ASSERT_EQ(stats.entries, 1);
+  ASSERT_EQ(stats.bytes, size);
+  // a changed value misses
+  copy[len / 2] += 1;
+  ASSERT_NE(cache.compress(elias, copy.data(), len).get(), first.get());
+  ASSERT_EQ(cache.stats().misses, 2);
+}
+
+TEST(BufferCache_Configuration, CheckValues) {
+  std::size_t len = 3000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::BufferCache cache(1 << 20);
+  compc::EliasGamma<long> gamma{1, true};
+  compc::EliasGamma<long> other_offset{2, true};
+  compc::EliasDelta<long> delta{1, true};
+  compc::EliasGamma<long> lsb_first{1, true};
+  lsb_first.bit_order = compc::BitOrder::lsb_first;
+  std::vector<compc::EliasBase<long>*> codecs = {&gamma, &other_offset, &delta, &lsb_first};
+  std::vector<const compc::CompressedBytes*> buffers;
+  for (compc::EliasBase<long>* codec : codecs) {
+    compc::CachedBuffer buffer = cache.compress(*codec, random_array.get(), len);
+    for (const compc::CompressedBytes* previous : buffers) {
+      ASSERT_NE(buffer.get(), previous);
+    }
+    buffers.push_back(buffer.get());
+    std::unique_ptr<long[]> output = codec->decompress(buffer->data.get(), buffer->size, len);
+    ASSERT_EQ(output[len - 1], random_array[len - 1]);
+  }
+  // the same bytes of another type are another entry
+  std::vector<uint16_t> unsigned_values(len, 5);
+  std::vector<int16_t> signed_values(len, 5);
+  compc::EliasGamma<uint16_t> unsigned_codec;
+  compc::EliasGamma<int16_t> signed_codec;
+  ASSERT_NE(cache.compress(unsigned_codec, unsigned_values.data(), len).get(),
+            cache.compress(signed_codec, signed_values.data(), len).get());
+  compc::BufferCacheStats stats = cache.stats();
+  ASSERT_EQ(stats.hits, 0);
+  ASSERT_EQ(stats.misses, 6);
+  ASSERT_EQ(stats.entries, 6);
+}
+
+TEST(BufferCache_Eviction, CheckValues) {
+  std::size_t len = 2000;
+  std::vector<std::vector<uint32_t>> arrays(4);
+  for (std::size_t a = 0; a < arrays.size(); a++) {
+    arrays[a].assign(len, static_cast<uint32_t>(a + 4)); // codes of 5 bits each
+  }
+  compc::EliasGamma<uint32_t> elias;
+  std::size_t entry_bytes = len;
+  ASSERT_NE(elias.compress(arrays[2].data(), entry_bytes), nullptr);
+  compc::BufferCache cache(3 * entry_bytes);
+  compc::CachedBuffer oldest = cache.compress(elias, arrays[0].data(), len);
+  cache.compress(elias, arrays[1].data(), len);
+  cache.compress(elias, arrays[2].data(), len);
+  // using the first array makes the second one the least recently used
+  ASSERT_EQ(cache.compress(elias, arrays[0].data(), len).get(), oldest.get());
+  cache.compress(elias, arrays[3].data(), len);
+  compc::BufferCacheStats stats = cache.stats();
+  ASSERT_EQ(stats.evictions, 1);
+  ASSERT_EQ(stats.entries, 3);
+  ASSERT_LE(stats.bytes, cache.capacity());
+  ASSERT_EQ(cache.compress(elias, arrays[0].data(), len).get(), oldest.get());
+  ASSERT_EQ(cache.stats().hits, 2);
+  cache.compress(elias, arrays[1].data(), len);
+  ASSERT_EQ(cache.stats().misses, 5);
+  // a handle outlives the eviction and the clear
+  cache.clear();
+  ASSERT_EQ(cache.stats().entries, 0);
+  ASSERT_EQ(cache.stats().bytes, 0);
+  std::unique_ptr<uint32_t[]> output = elias.decompress(oldest->data.get(), oldest->size, oldest->values);
+  ASSERT_EQ(output[len - 1], 4);
+  // outputs larger than the capacity are returned but not cached
+  compc::BufferCache tiny(4);
+  ASSERT_NE(tiny.compress(elias, arrays[0].data(), len), nullptr);
+  ASSERT_EQ(tiny.stats().entries, 0);
+}
+
+TEST(BufferCache_InvalidInput, CheckValues) {
+  uint32_t input[4] = {3, 0, 1, 2};
+  compc::BufferCache cache(1024);
+  compc::EliasGamma<uint32_t> elias;
+  ASSERT_EQ(cache.compress(elias, input, 4), nullptr);
+  ASSERT_EQ(cache.stats().entries, 0);
+}
+
+TEST(BufferCache_ConcurrentSenders, CheckValues) {
+  std::size_t len = 20000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::BufferCache cache(1 << 20);
+  std::vector<compc::CachedBuffer> handles(4);
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < 4; t++) {
+    threads.emplace_back([&, t] {
+      compc::EliasDelta<long> elias{1, true};
+      for (int round = 0; round < 10; round++) {
+        handles[t] = cache.compress(elias, random_array.get(), len);
+      }
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  // every sender ends up with the one cached copy
+  for (std::size_t t = 1; t < 4; t++) {
+    ASSERT_EQ(handles[t].get(), handles[0].get());
+  }
+  compc::BufferCacheStats stats = cache.stats();
+  ASSERT_EQ(stats.hits + stats.misses, 40);
+  ASSERT_EQ(stats.entries, 1);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,172 @@
+#include "compintc/container.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_factory.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "compintc/helpers.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+
+template <typename Codec> void check_round_trip(Codec& elias, bool chunk_index) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<long>(elias, random_array.get(), len, chunk_index);
+  ASSERT_NE(frame, nullptr);
+  compc::FrameHeader header;
+  ASSERT_TRUE(compc::read_frame_header(frame.get(), len, header));
+  ASSERT_EQ(header.codec, elias.codec_id());
+  ASSERT_EQ(header.count, len_copy);
+  ASSERT_EQ(header.has_chunk_index, chunk_index);
+  std::size_t output_length = 0;
+  std::unique_ptr<long[]> output = compc::decompress_auto<long>(frame.get(), len, output_length, 4);
+  ASSERT_NE(output, nullptr);
+  ASSERT_EQ(output_length, len_copy);
+  for (std::size_t i = 0; i < len_copy; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(Container_RoundTripGamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  check_round_trip(elias, true);
+  check_round_trip(elias, false);
+}
+
+TEST(Container_RoundTripDelta, CheckValues) {
+  compc::EliasDelta<long> elias;
+  elias.num_threads = 4;
+  check_round_trip(elias, true);
+  check_round_trip(elias, false);
+}
+
+TEST(Container_RoundTripOmega, CheckValues) {
+  compc::EliasOmega<long> elias;
+  elias.num_threads = 4;
+  check_round_trip(elias, true);
+  check_round_trip(elias, false);
+}
+
+TEST(Container_TransformsInHeader, CheckValues) {
+  std::size_t size = 10;
+  int32_t input[10] = {0, -3, 2000, 2, -50, 1, 25345, -11, 1000000, 0};
+  compc::EliasDelta<int32_t> elias{1, true};
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<int32_t>(elias, input, size);
+  std::size_t output_length = 0;
+  // the decoder does not need to know the codec, offset or mapping
+  std::unique_ptr<int32_t[]> output = compc::decompress_auto<int32_t>(frame.get(), size, output_length);
+  ASSERT_EQ(output_length, 10);
+  for (std::size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+  }
+}
+
+TEST(Container_LargeValues, CheckValues) {
+  uint64_t input[8] = {1, 1ULL << 40U, (1ULL << 62U) + 12345, 3, 1ULL << 63U, 17, (1ULL << 32U) - 1, 2};
+  for (compc::CodecId codec : {compc::CodecId::gamma, compc::CodecId::delta, compc::CodecId::omega}) {
+    for (bool chunk_index : {true, false}) {
+      std::size_t size = 8;
+      std::unique_ptr<compc::EliasBase<uint64_t>> elias = compc::make_elias<uint64_t>(codec);
+      std::unique_ptr<uint8_t[]> frame = compc::compress_framed<uint64_t>(*elias, input, size, chunk_index);
+      std::size_t output_length = 0;
+      std::unique_ptr<uint64_t[]> output = compc::decompress_auto<uint64_t>(frame.get(), size, output_length);
+      for (std::size_t i = 0; i < 8; i++) {
+        ASSERT_EQ(output[i], input[i]); // comparing values
+      }
+    }
+  }
+}
+
+TEST(Container_TypeMismatch, CheckValues) {
+  std::size_t size = 5;
+  uint32_t input[5] = {1, 2, 5, 10, 17};
+  compc::EliasOmega<uint32_t> elias;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<uint32_t>(elias, input, size);
+  std::size_t output_length = 0;
+  ASSERT_EQ(compc::decompress_auto<int32_t>(frame.get(), size, output_length), nullptr);
+  ASSERT_EQ(compc::decompress_auto<uint64_t>(frame.get(), size, output_length), nullptr);
+  ASSERT_NE(compc::decompress_auto<uint32_t>(frame.get(), size, output_length), nullptr);
+}
+
+TEST(Container_MalformedFrames, CheckValues) {
+  std::size_t size = 5;
+  uint16_t input[5] = {1, 2, 5, 10, 17};
+  compc::EliasGamma<uint16_t> elias;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<uint16_t>(elias, input, size);
+  std::size_t output_length = 0;
+  // truncated
+  ASSERT_EQ(compc::decompress_auto<uint16_t>(frame.get(), size - 1, output_length), nullptr);
+  ASSERT_EQ(compc::decompress_auto<uint16_t>(frame.get(), 10, output_length), nullptr);
+  // unknown codec
+  frame[4] = 7;
+  ASSERT_EQ(compc::decompress_auto<uint16_t>(frame.get(), size, output_length), nullptr);
+  // bad magic
+  frame[4] = static_cast<uint8_t>(compc::CodecId::gamma);
+  frame[0] = 'X';
+  ASSERT_EQ(compc::decompress_auto<uint16_t>(frame.get(), size, output_length), nullptr);
+}
+
+TEST(Container_ChecksumsDetectCorruptChunks, CheckValues) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<long>(elias, random_array.get(), len, true, true);
+  compc::FrameHeader header;
+  ASSERT_TRUE(compc::read_frame_header(frame.get(), len, header));
+  ASSERT_TRUE(header.has_checksums);
+  ASSERT_TRUE(compc::verify_frame(frame.get(), len));
+  std::size_t output_length = 0;
+  std::vector<std::size_t> corrupt_chunks;
+  std::unique_ptr<long[]> output = compc::decompress_auto<long>(frame.get(), len, output_length, 4, &corrupt_chunks);
+  ASSERT_NE(output, nullptr);
+  ASSERT_TRUE(corrupt_chunks.empty());
+  for (std::size_t i = 0; i < len_copy; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+
+  // flip a bit in the middle of the payload
+  std::size_t payload_start = header.header_bytes();
+  std::size_t flipped_bit = (len - payload_start) * 4;
+  frame[payload_start + flipped_bit / 8] ^= static_cast<uint8_t>(0x80U >> (flipped_bit % 8));
+  ASSERT_FALSE(compc::verify_frame(frame.get(), len, &corrupt_chunks));
+  ASSERT_EQ(corrupt_chunks.size(), 1);
+  std::size_t end_bit = 0;
+  std::size_t expected_chunk = 0;
+  for (std::size_t i = 0; i < header.chunk_count; i++) {
+    end_bit += hlprs::load_le<uint32_t>(frame.get() + compc::frame_header_size + i * sizeof(uint32_t));
+    if (flipped_bit < end_bit) {
+      expected_chunk = i;
+      break;
+    }
+  }
+  ASSERT_EQ(corrupt_chunks[0], expected_chunk);
+  corrupt_chunks.clear();
+  ASSERT_EQ(compc::decompress_auto<long>(frame.get(), len, output_length, 4, &corrupt_chunks), nullptr);
+  ASSERT_EQ(corrupt_chunks.size(), 1);
+  ASSERT_EQ(corrupt_chunks[0], expected_chunk);
+
+  // a corrupt header is detected as well
+  frame[payload_start + flipped_bit / 8] ^= static_cast<uint8_t>(0x80U >> (flipped_bit % 8));
+  ASSERT_TRUE(compc::verify_frame(frame.get(), len));
+  frame[compc::frame_header_size] ^= 1U;
+  ASSERT_FALSE(compc::read_frame_header(frame.get(), len, header));
+}
+
+TEST(Container_EmptyArray, CheckValues) {
+  std::size_t size = 0;
+  compc::EliasGamma<int64_t> elias;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<int64_t>(elias, nullptr, size);
+  ASSERT_EQ(size, compc::frame_header_size);
+  std::size_t output_length = 1;
+  ASSERT_NE(compc::decompress_auto<int64_t>(frame.get(), size, output_length), nullptr);
+  ASSERT_EQ(output_length, 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,43 @@
+#include "compintc/crc32c.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+TEST(Crc32c_KnownValue, CheckValues) {
+  const char* input = "123456789";
+  auto data = reinterpret_cast<const uint8_t*>(input);
+  ASSERT_EQ(compc::crc32c(data, 9), 0xE3069283U);
+  ASSERT_EQ(compc::crc32c_portable(data, 9), 0xE3069283U);
+  // continuing a checksum
+  ASSERT_EQ(compc::crc32c(data + 4, 5, compc::crc32c(data, 4)), 0xE3069283U);
+}
+
+TEST(Crc32c_HardwareEqualsPortable, CheckValues) {
+  std::mt19937 engine(7);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8_t> data(4099);
+  for (auto& byte : data) {
+    byte = static_cast<uint8_t>(dist(engine));
+  }
+  std::cout << "hardware accelerated: " << compc::crc32c_hardware_accelerated() << std::endl;
+  for (std::size_t length : {0UL, 1UL, 7UL, 8UL, 9UL, 63UL, 4099UL}) {
+    ASSERT_EQ(compc::crc32c(data.data(), length), compc::crc32c_portable(data.data(), length));
+  }
+}
+
+TEST(Crc32c_BitsIgnoresNeighbours, CheckValues) {
+  uint8_t a[4] = {0xAB, 0xCD, 0xEF, 0x12};
+  uint8_t b[4] = {0x0B, 0xCD, 0xEF, 0x1F}; // differs only outside of bits [4, 28)
+  ASSERT_EQ(compc::crc32c_bits(a, 4, 28), compc::crc32c_bits(b, 4, 28));
+  ASSERT_NE(compc::crc32c_bits(a, 2, 28), compc::crc32c_bits(b, 2, 28));
+  ASSERT_NE(compc::crc32c_bits(a, 4, 29), compc::crc32c_bits(b, 4, 29));
+  // range within a single byte
+  ASSERT_EQ(compc::crc32c_bits(a, 9, 15), compc::crc32c_bits(b, 9, 15));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#include "compintc/container.hpp"
+#include "compintc/decode_apply.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+TEST(DecodeApply_ForEach, CheckValues) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  for (bool chunk_index : {true, false}) {
+    std::size_t size = len_copy;
+    std::unique_ptr<uint8_t[]> frame = compc::compress_framed<long>(elias, random_array.get(), size, chunk_index);
+    std::vector<long> seen(len_copy, 0);
+    ASSERT_TRUE(compc::decode_apply<long>(
+        frame.get(), size, [&](std::size_t position, long value) { seen[position] = value; }, 4));
+    for (std::size_t i = 0; i < len_copy; i++) {
+      ASSERT_EQ(seen[i], random_array[i]); // comparing values
+    }
+  }
+}
+
+TEST(DecodeApply_Transforms, CheckValues) {
+  std::size_t size = 10;
+  int32_t input[10] = {0, -3, 2000, 2, -50, 1, 25345, -11, 1000000, 0};
+  compc::EliasDelta<int32_t> elias{1, true};
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<int32_t>(elias, input, size, true, true);
+  std::vector<int32_t> seen(10, 7);
+  ASSERT_TRUE(compc::decode_apply<int32_t>(frame.get(), size,
+                                           [&](std::size_t position, int32_t value) { seen[position] = value; }));
+  for (std::size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(seen[i], input[i]);
+  }
+  // the wrong type is rejected before the sink is called
+  ASSERT_FALSE(compc::decode_apply<int64_t>(frame.get(), size, [](std::size_t, int64_t) { FAIL(); }));
+}
+
+TEST(DecodeApply_ScatterAdd, CheckValues) {
+  // repeated indices in different chunks are added atomically
+  std::size_t len = 20000;
+  std::vector<uint32_t> indices(len);
+  std::vector<float> values(len);
+  for (std::size_t i = 0; i < len; i++) {
+    indices[i] = static_cast<uint32_t>((i * 7) % 1000);
+    values[i] = 0.5F;
+  }
+  compc::EliasGamma<uint32_t> elias{1, false};
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<uint32_t>(elias, indices.data(), size);
+  std::vector<float> dense(1000, 1.0F);
+  ASSERT_TRUE((compc::scatter_add<uint32_t, float>(frame.get(), size, values.data(), dense.data(), dense.size(), 4)));
+  for (float value : dense) {
+    ASSERT_FLOAT_EQ(value, 11.0F);
+  }
+  std::vector<float> small(10, 0.0F);
+  ASSERT_FALSE(
+      (compc::scatter_add<uint32_t, float>(frame.get(), size, values.data(), small.data(), small.size())));
+}
+
+TEST(DecodeApply_SetBits, CheckValues) {
+  std::size_t size = 5;
+  uint64_t indices[5] = {1, 64, 65, 127, 3};
+  compc::EliasGamma<uint64_t> elias;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<uint64_t>(elias, indices, size);
+  uint64_t bitset[2] = {0, 0};
+  ASSERT_TRUE(compc::set_bits<uint64_t>(frame.get(), size, bitset, 128));
+  ASSERT_EQ(bitset[0], (uint64_t{1} << 1U) | (uint64_t{1} << 3U));
+  ASSERT_EQ(bitset[1], uint64_t{1} | (uint64_t{1} << 1U) | (uint64_t{1} << 63U));
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
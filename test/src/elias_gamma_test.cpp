@@ -1,9 +1,13 @@
 #include "compintc/elias_gamma.hpp"
 #include "helpers.hpp"
+#include <algorithm>
+#include <atomic>
 #include <bitset>
 #include <chrono>
 #include <cstdint>
 #include <gtest/gtest.h>
+#include <utility>
+#include <vector>
 using namespace std::chrono;
 
 TEST(Elias_Gamma_DecompCompEQTestLong, CheckValues) {
@@ -191,6 +195,133 @@ TEST(Elias_Gamma_DecompCompEQTestNegativeLong, CheckValues) {
   }
 }
 
+TEST(Elias_Gamma_StatsTestLong, CheckValues) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::CompressionStats stats;
+  compc::EliasGamma<long> elias{1, true};
+  elias.num_threads = 4;
+  elias.stats = &stats;
+  std::unique_ptr<uint8_t[]> comp = elias.compress(random_array.get(), len);
+  ASSERT_EQ(stats.total_chunks, (len_copy + stats.batch_size - 1) / stats.batch_size);
+  ASSERT_EQ(stats.threads_used, 4);
+  ASSERT_EQ(stats.chunks_per_thread.size(), 4);
+  std::size_t chunks = 0;
+  for (std::size_t c : stats.chunks_per_thread) {
+    chunks += c;
+  }
+  ASSERT_EQ(chunks, stats.total_chunks);
+  ASSERT_GT(stats.encode_ns, 0);
+  ASSERT_GT(stats.transform_ns, 0);
+  ASSERT_NEAR(stats.bits_per_value, static_cast<double>(len * 8) / static_cast<double>(len_copy), 8.0 / static_cast<double>(len_copy));
+
+  std::unique_ptr<long[]> output = elias.decompress(comp.get(), len, len_copy);
+  ASSERT_GT(stats.decode_ns, 0);
+  ASSERT_EQ(stats.encode_ns, 0);
+  for (std::size_t i = 0; i < len_copy; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(Elias_Gamma_StatsDisabledTestLong, CheckValues) {
+  std::size_t size = 10;
+  long input[10] = {1, 3, 2000, 2, 50, 1, 25345, 11, 10000000, 1};
+  compc::EliasGamma<long> elias;
+  ASSERT_EQ(elias.stats, nullptr);
+  std::unique_ptr<uint8_t[]> comp = elias.compress(input, size);
+  std::unique_ptr<long[]> output = elias.decompress(comp.get(), size, 10);
+  for (std::size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+  }
+}
+
+TEST(Elias_Gamma_SkewedBalanceTestLong, CheckValues) {
+  // small values first, then values that need far more bits per element
+  std::size_t size = 200000;
+  std::vector<long> input(size);
+  for (std::size_t i = 0; i < size; i++) {
+    input[i] = i < size / 2 ? static_cast<long>(i % 4) : 1000000000L + static_cast<long>(i);
+  }
+  compc::CompressionStats stats;
+  compc::EliasGamma<long> balanced{1, true};
+  balanced.num_threads = 4;
+  balanced.stats = &stats;
+  std::size_t len = size;
+  std::unique_ptr<uint8_t[]> comp = balanced.compress(input.data(), len);
+  ASSERT_EQ(stats.chunks_per_thread.size(), 4);
+  // the threads of the large values get fewer chunks
+  ASSERT_GT(stats.chunks_per_thread[0], stats.chunks_per_thread[3]);
+
+  compc::EliasGamma<long> serial{1, true};
+  serial.num_threads = 1;
+  std::size_t serial_len = size;
+  std::unique_ptr<uint8_t[]> serial_comp = serial.compress(input.data(), serial_len);
+  ASSERT_EQ(len, serial_len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(comp[i], serial_comp[i]); // same stream for every partition
+  }
+  std::unique_ptr<long[]> output = balanced.decompress(comp.get(), len, size);
+  for (std::size_t i = 0; i < size; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+  }
+}
+
+TEST(Elias_Gamma_FinalPrefixTestLong, CheckValues) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  std::atomic<std::size_t> watermark{0};
+  std::vector<std::pair<std::size_t, std::vector<uint8_t>>> prefixes;
+  elias.final_prefix_bytes = &watermark;
+  elias.on_final_prefix = [&](const uint8_t* compressed, std::size_t final_bytes) {
+    prefixes.emplace_back(final_bytes, std::vector<uint8_t>(compressed, compressed + final_bytes));
+  };
+  std::unique_ptr<uint8_t[]> comp = elias.compress(random_array.get(), len);
+  ASSERT_GT(prefixes.size(), 1);
+  ASSERT_EQ(prefixes.back().first, len);
+  ASSERT_EQ(watermark.load(), len);
+  std::size_t previous = 0;
+  for (const auto& [final_bytes, bytes] : prefixes) {
+    ASSERT_GT(final_bytes, previous);
+    previous = final_bytes;
+    // a byte reported as final never changes afterwards
+    for (std::size_t i = 0; i < final_bytes; i++) {
+      ASSERT_EQ(bytes[i], comp[i]);
+    }
+  }
+  std::unique_ptr<long[]> output = elias.decompress(comp.get(), len, len_copy);
+  for (std::size_t i = 0; i < len_copy; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(Elias_Gamma_FinalPrefixSkewedTestLong, CheckValues) {
+  // the skewed input of the balance test, a range per thread would hold the prefix back until the end
+  std::size_t size = 2000000;
+  std::vector<long> input(size);
+  for (std::size_t i = 0; i < size; i++) {
+    input[i] = i < size / 2 ? static_cast<long>(i % 4) : 1000000000L + static_cast<long>(i);
+  }
+  compc::EliasGamma<long> elias{1, true};
+  elias.num_threads = 4;
+  std::vector<std::size_t> reported;
+  elias.on_final_prefix = [&](const uint8_t*, std::size_t final_bytes) { reported.push_back(final_bytes); };
+  std::size_t len = size;
+  std::unique_ptr<uint8_t[]> comp = elias.compress(input.data(), len);
+  ASSERT_EQ(reported.back(), len);
+  // the prefix passes half of the output, far beyond the first quarter of the bits, before the last chunk is done
+  ASSERT_TRUE(std::any_of(reported.begin(), reported.end(),
+                          [&](std::size_t final_bytes) { return final_bytes > len / 2 && final_bytes < len; }));
+  ASSERT_GT(reported.size(), 8);
+  std::unique_ptr<long[]> output = elias.decompress(comp.get(), len, size);
+  for (std::size_t i = 0; i < size; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+  }
+}
+
 // TODO: For offset and mapping to numbers we are not doing an overflow check.
 // The above test fails for short.
 
@@ -0,0 +1,98 @@
+#include "compintc/elias_gamma.hpp"
+#include "compintc/hybrid_huffman.hpp"
+#include "helpers.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+template <typename T> void check_round_trip(compc::HybridHuffman<T>& codec, const T* input, std::size_t len) {
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> compressed = codec.compress(input, size);
+  ASSERT_NE(compressed, nullptr);
+  ASSERT_EQ(size, codec.get_compressed_length(input, len));
+  std::unique_ptr<T[]> output = codec.decompress(compressed.get(), size, len);
+  ASSERT_NE(output, nullptr);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+  }
+}
+
+TEST(HybridHuffman_RandomArray, CheckValues) {
+  std::size_t len = 100001;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::HybridHuffman<long> codec;
+  codec.num_threads = 4;
+  check_round_trip(codec, random_array.get(), len);
+  codec.block_size = 100;
+  check_round_trip(codec, random_array.get(), len);
+}
+
+TEST(HybridHuffman_SkewedLengths, CheckValues) {
+  // mostly large values of the same length, the unary prefix of gamma spends 2 * 20 + 1 bits on most of them
+  std::size_t len = 50000;
+  std::vector<uint32_t> input(len);
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<uint32_t> large(1U << 20U, (1U << 21U) - 1);
+  for (std::size_t i = 0; i < len; i++) {
+    input[i] = i % 10 == 0 ? static_cast<uint32_t>(i % 7 + 1) : large(generator);
+  }
+  compc::HybridHuffman<uint32_t> codec;
+  check_round_trip(codec, input.data(), len);
+  compc::EliasGamma<uint32_t> gamma;
+  ASSERT_LT(codec.get_compressed_length(input.data(), len) * 8, gamma.get_compressed_length(input.data(), len) * 3 / 5);
+}
+
+TEST(HybridHuffman_LongCodes, CheckValues) {
+  // halving counts per length give codes longer than the lookup table of the decoder
+  std::vector<uint32_t> input;
+  for (uint32_t symbol = 0; symbol <= 24; symbol++) {
+    for (uint32_t i = 0; i < std::max(4096U >> symbol, 1U); i++) {
+      input.push_back((1U << symbol) | (i & ((1U << symbol) - 1)));
+    }
+  }
+  std::shuffle(input.begin(), input.end(), std::mt19937(3));
+  compc::HybridHuffman<uint32_t> codec;
+  codec.block_size = static_cast<uint32_t>(input.size());
+  check_round_trip(codec, input.data(), input.size());
+  codec.block_size = 1000;
+  check_round_trip(codec, input.data(), input.size());
+}
+
+TEST(HybridHuffman_SingleLength, CheckValues) {
+  // blocks with a single length need no code at all
+  std::vector<uint16_t> ones(5000, 1);
+  compc::HybridHuffman<uint16_t> codec;
+  check_round_trip(codec, ones.data(), ones.size());
+  std::vector<uint64_t> large(3000, ~uint64_t{0});
+  large[1500] = uint64_t{1} << 63U;
+  compc::HybridHuffman<uint64_t> codec64;
+  check_round_trip(codec64, large.data(), large.size());
+}
+
+TEST(HybridHuffman_Transforms, CheckValues) {
+  int32_t input[10] = {0, -3, 2000, 2, -50, 1, 25345, -11, 1000000, 0};
+  compc::HybridHuffman<int32_t> codec{1, true};
+  check_round_trip(codec, input, 10);
+  // zero cannot be encoded without an offset
+  compc::HybridHuffman<int32_t> plain;
+  std::size_t size = 10;
+  ASSERT_EQ(plain.compress(input, size), nullptr);
+  ASSERT_EQ(size, 10);
+}
+
+TEST(HybridHuffman_Malformed, CheckValues) {
+  std::size_t len = 10000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::HybridHuffman<long> codec;
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> compressed = codec.compress(random_array.get(), size);
+  ASSERT_EQ(codec.decompress(compressed.get(), size - 1, len), nullptr);
+  ASSERT_EQ(codec.decompress(compressed.get(), 2, len), nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,83 @@
+#include "compintc/index_set.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// sparse, dense and contiguous regions of a top-k selection
+std::vector<uint32_t> mixed_indices() {
+  std::mt19937 generator(3);
+  std::vector<uint32_t> indices;
+  std::bernoulli_distribution sparse(0.001);
+  std::bernoulli_distribution dense(0.75);
+  for (uint32_t i = 0; i < (1U << 16U); i++) {
+    if (sparse(generator)) {
+      indices.push_back(i);
+    }
+  }
+  for (uint32_t i = 1U << 16U; i < (2U << 16U); i++) {
+    if (dense(generator)) {
+      indices.push_back(i);
+    }
+  }
+  for (uint32_t i = (5U << 16U) + 100; i < (5U << 16U) + 20000; i++) {
+    indices.push_back(i);
+  }
+  indices.push_back(7U << 16U);           // single index
+  indices.push_back((9U << 16U) + 65535); // last index of a block
+  return indices;
+}
+
+void check_index_set(compc::CodecId codec) {
+  std::vector<uint32_t> indices = mixed_indices();
+  compc::CompressedIndexSet set = compc::compress_index_set<uint32_t>(indices.data(), indices.size(), codec, 4);
+  ASSERT_NE(set.payload, nullptr);
+  ASSERT_EQ(set.blocks.size(), 5);
+  ASSERT_EQ(set.blocks[0].container, compc::BlockContainer::gaps);
+  ASSERT_EQ(set.blocks[1].container, compc::BlockContainer::bitmap);
+  ASSERT_EQ(set.blocks[2].container, compc::BlockContainer::runs);
+  std::unique_ptr<uint32_t[]> output = compc::decompress_index_set<uint32_t>(set, 4);
+  ASSERT_NE(output, nullptr);
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    ASSERT_EQ(output[i], indices[i]);
+  }
+}
+
+TEST(IndexSet_RoundTripGamma, CheckValues) { check_index_set(compc::CodecId::gamma); }
+
+TEST(IndexSet_RoundTripDelta, CheckValues) { check_index_set(compc::CodecId::delta); }
+
+TEST(IndexSet_RoundTripOmega, CheckValues) { check_index_set(compc::CodecId::omega); }
+
+TEST(IndexSet_SmallTypes, CheckValues) {
+  int16_t indices[5] = {0, 1, 2, 1000, 32767};
+  compc::CompressedIndexSet set = compc::compress_index_set<int16_t>(indices, 5);
+  std::unique_ptr<int16_t[]> output = compc::decompress_index_set<int16_t>(set);
+  ASSERT_NE(output, nullptr);
+  for (std::size_t i = 0; i < 5; i++) {
+    ASSERT_EQ(output[i], indices[i]);
+  }
+  // the set does not fit into a smaller type
+  uint64_t large[2] = {1, uint64_t{1} << 40U};
+  compc::CompressedIndexSet large_set = compc::compress_index_set<uint64_t>(large, 2);
+  ASSERT_EQ(compc::decompress_index_set<uint32_t>(large_set), nullptr);
+  ASSERT_NE(compc::decompress_index_set<uint64_t>(large_set), nullptr);
+}
+
+TEST(IndexSet_InvalidInput, CheckValues) {
+  int32_t unsorted[3] = {1, 5, 5};
+  ASSERT_EQ(compc::compress_index_set<int32_t>(unsorted, 3).payload, nullptr);
+  int32_t negative[2] = {-1, 5};
+  ASSERT_EQ(compc::compress_index_set<int32_t>(negative, 2).payload, nullptr);
+}
+
+TEST(IndexSet_Empty, CheckValues) {
+  compc::CompressedIndexSet set = compc::compress_index_set<uint32_t>(nullptr, 0);
+  ASSERT_NE(set.payload, nullptr);
+  ASSERT_NE(compc::decompress_index_set<uint32_t>(set), nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,213 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/index_stream.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <random>
+#include <vector>
+
+std::vector<uint32_t> random_indices(std::size_t length, uint32_t universe, unsigned seed) {
+  std::mt19937 generator(seed);
+  std::uniform_int_distribution<uint32_t> distribution(0, universe - 1);
+  std::vector<uint32_t> indices(length);
+  for (uint32_t& index : indices) {
+    index = distribution(generator);
+  }
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+  return indices;
+}
+
+std::vector<uint32_t> decoded(const compc::GapStream& stream) {
+  std::unique_ptr<uint32_t[]> output = compc::decode_gap_stream<uint32_t>(stream);
+  return std::vector<uint32_t>(output.get(), output.get() + stream.count);
+}
+
+TEST(IndexStream_RoundTrip, CheckValues) {
+  std::vector<uint32_t> indices = random_indices(10000, 1000000, 1);
+  for (compc::CodecId codec : {compc::CodecId::gamma, compc::CodecId::delta, compc::CodecId::omega}) {
+    std::unique_ptr<compc::GapStream> stream =
+        compc::encode_gap_stream<uint32_t>(indices.data(), indices.size(), codec);
+    ASSERT_NE(stream, nullptr);
+    ASSERT_EQ(decoded(*stream), indices);
+  }
+}
+
+TEST(IndexStream_MatchesCompress, CheckValues) {
+  // the stream is the output of compress() for the gaps
+  std::vector<uint32_t> indices = random_indices(1000, 50000, 2);
+  std::vector<uint64_t> gaps;
+  uint64_t previous = 0;
+  for (uint32_t index : indices) {
+    gaps.push_back(gaps.empty() ? index + uint64_t{1} : index - previous);
+    previous = index;
+  }
+  compc::EliasDelta<uint64_t> elias;
+  std::size_t size = gaps.size();
+  std::unique_ptr<uint8_t[]> compressed = elias.compress(gaps.data(), size);
+  std::unique_ptr<compc::GapStream> stream =
+      compc::encode_gap_stream<uint32_t>(indices.data(), indices.size(), compc::CodecId::delta);
+  ASSERT_EQ(stream->data.size(), size);
+  ASSERT_TRUE(std::equal(stream->data.begin(), stream->data.end(), compressed.get()));
+}
+
+TEST(IndexStream_UnionAndIntersection, CheckValues) {
+  std::vector<std::vector<uint32_t>> inputs = {random_indices(5000, 20000, 3), random_indices(8000, 20000, 4),
+                                               random_indices(3000, 20000, 5)};
+  std::vector<std::unique_ptr<compc::GapStream>> streams;
+  std::vector<const compc::GapStream*> pointers;
+  for (const std::vector<uint32_t>& input : inputs) {
+    streams.push_back(compc::encode_gap_stream<uint32_t>(input.data(), input.size()));
+    pointers.push_back(streams.back().get());
+  }
+  std::vector<uint32_t> expected_union;
+  std::vector<uint32_t> expected_intersection = inputs[0];
+  for (const std::vector<uint32_t>& input : inputs) {
+    std::vector<uint32_t> merged;
+    std::set_union(expected_union.begin(), expected_union.end(), input.begin(), input.end(),
+                   std::back_inserter(merged));
+    expected_union = merged;
+    std::vector<uint32_t> common;
+    std::set_intersection(expected_intersection.begin(), expected_intersection.end(), input.begin(), input.end(),
+                          std::back_inserter(common));
+    expected_intersection = common;
+  }
+  std::unique_ptr<compc::GapStream> united = compc::union_streams(pointers, compc::CodecId::delta);
+  ASSERT_NE(united, nullptr);
+  ASSERT_EQ(united->codec, compc::CodecId::delta);
+  ASSERT_EQ(decoded(*united), expected_union);
+  std::unique_ptr<compc::GapStream> common = compc::intersect_streams(pointers);
+  ASSERT_NE(common, nullptr);
+  ASSERT_FALSE(expected_intersection.empty());
+  ASSERT_EQ(decoded(*common), expected_intersection);
+}
+
+TEST(IndexStream_EmptyInputs, CheckValues) {
+  std::vector<uint32_t> indices = {1, 5, 9};
+  std::unique_ptr<compc::GapStream> stream = compc::encode_gap_stream<uint32_t>(indices.data(), indices.size());
+  compc::GapStream empty;
+  ASSERT_EQ(decoded(*compc::union_streams({stream.get(), &empty})), indices);
+  ASSERT_EQ(compc::intersect_streams({stream.get(), &empty})->count, 0);
+  ASSERT_EQ(compc::union_streams({})->count, 0);
+}
+
+TEST(IndexStream_InvalidInput, CheckValues) {
+  int64_t unsorted[3] = {1, 5, 3};
+  ASSERT_EQ(compc::encode_gap_stream<int64_t>(unsorted, 3), nullptr);
+  int64_t negative[2] = {-2, 3};
+  ASSERT_EQ(compc::encode_gap_stream<int64_t>(negative, 2), nullptr);
+  // a stream claiming more indices than it contains
+  std::unique_ptr<compc::GapStream> stream = compc::encode_gap_stream<int64_t>(unsorted, 2);
+  stream->count = 1000;
+  ASSERT_EQ(compc::decode_gap_stream<int64_t>(*stream), nullptr);
+  ASSERT_EQ(compc::union_streams({stream.get()}), nullptr);
+}
+
+TEST(IndexStream_LowerBound, CheckValues) {
+  std::vector<uint32_t> indices = random_indices(20000, 5000000, 4);
+  for (compc::CodecId codec : {compc::CodecId::gamma, compc::CodecId::delta, compc::CodecId::omega}) {
+    std::unique_ptr<compc::GapStream> stream =
+        compc::encode_gap_stream<uint32_t>(indices.data(), indices.size(), codec);
+    ASSERT_EQ(stream->skips.size(), (indices.size() - 1) / compc::stream_block_size);
+    // a stream without skip pointers gets the same ones added
+    compc::GapStream plain{stream->codec, stream->count, stream->data, {}};
+    ASSERT_TRUE(compc::add_skip_pointers(plain));
+    ASSERT_EQ(plain.skips.size(), stream->skips.size());
+    for (std::size_t b = 0; b < plain.skips.size(); b++) {
+      ASSERT_EQ(plain.skips[b].last, stream->skips[b].last);
+      ASSERT_EQ(plain.skips[b].bit, stream->skips[b].bit);
+    }
+    std::mt19937 generator(5);
+    std::uniform_int_distribution<uint32_t> distribution(0, 5000100);
+    for (int query = 0; query < 2000; query++) {
+      uint32_t value = query % 2 == 0 ? distribution(generator) : indices[generator() % indices.size()];
+      auto expected = std::lower_bound(indices.begin(), indices.end(), value);
+      uint64_t found = 0;
+      ASSERT_EQ(compc::lower_bound(*stream, value, found), expected != indices.end());
+      if (expected != indices.end()) {
+        ASSERT_EQ(found, *expected);
+      }
+      ASSERT_EQ(compc::contains(*stream, value), expected != indices.end() && *expected == value);
+    }
+    // the block boundaries
+    for (std::size_t i = 0; i < indices.size(); i += compc::stream_block_size) {
+      for (std::size_t j : {i, i + 1, i + compc::stream_block_size - 1}) {
+        if (j < indices.size()) {
+          ASSERT_TRUE(compc::contains(*stream, indices[j]));
+          ASSERT_TRUE(compc::contains(plain, indices[j]));
+        }
+      }
+    }
+  }
+}
+
+TEST(IndexStream_SeekWithSkips, CheckValues) {
+  std::vector<uint32_t> indices = random_indices(5000, 100000, 6);
+  std::unique_ptr<compc::GapStream> stream = compc::encode_gap_stream<uint32_t>(indices.data(), indices.size());
+  compc::GapStreamReader reader(*stream);
+  uint64_t index = 0;
+  // forward seeks and reads continue after the index found
+  ASSERT_TRUE(reader.seek(indices[1000], index));
+  ASSERT_EQ(index, indices[1000]);
+  ASSERT_TRUE(reader.next(index));
+  ASSERT_EQ(index, indices[1001]);
+  ASSERT_TRUE(reader.seek(indices[1003] + 1, index));
+  ASSERT_EQ(index, indices[1004]);
+  ASSERT_TRUE(reader.seek(indices[4000], index));
+  ASSERT_EQ(index, indices[4000]);
+  // a target behind the reader returns the next index
+  ASSERT_TRUE(reader.seek(indices[10], index));
+  ASSERT_EQ(index, indices[4001]);
+  ASSERT_FALSE(reader.seek(indices.back() + 1, index));
+  // skip pointers that do not match the stream are ignored
+  stream->skips.pop_back();
+  ASSERT_TRUE(compc::contains(*stream, indices[4500]));
+}
+
+TEST(IndexStream_Serialize, CheckValues) {
+  std::vector<uint32_t> indices = random_indices(10000, 2000000, 6);
+  std::unique_ptr<compc::GapStream> stream =
+      compc::encode_gap_stream<uint32_t>(indices.data(), indices.size(), compc::CodecId::delta);
+  std::vector<uint8_t> bytes = compc::serialize_gap_stream(*stream);
+  std::unique_ptr<compc::GapStream> received = compc::deserialize_gap_stream(bytes.data(), bytes.size());
+  ASSERT_NE(received, nullptr);
+  ASSERT_EQ(received->codec, compc::CodecId::delta);
+  ASSERT_EQ(received->count, indices.size());
+  ASSERT_EQ(received->data, stream->data);
+  // the skip pointers arrive with the stream
+  ASSERT_EQ(received->skips.size(), stream->skips.size());
+  for (std::size_t b = 0; b < received->skips.size(); b++) {
+    ASSERT_EQ(received->skips[b].last, stream->skips[b].last);
+    ASSERT_EQ(received->skips[b].bit, stream->skips[b].bit);
+  }
+  uint64_t index = 0;
+  std::size_t middle = indices.size() / 2;
+  ASSERT_TRUE(compc::lower_bound(*received, uint64_t{indices[middle]} + 1, index));
+  ASSERT_EQ(index, indices[middle + 1]);
+  ASSERT_TRUE(compc::contains(*received, indices.back()));
+  // without the table the stream is 16 bytes per block smaller
+  std::vector<uint8_t> plain = compc::serialize_gap_stream(*stream, false);
+  ASSERT_EQ(plain.size() + stream->skips.size() * 16, bytes.size());
+  std::unique_ptr<compc::GapStream> plain_received = compc::deserialize_gap_stream(plain.data(), plain.size());
+  ASSERT_NE(plain_received, nullptr);
+  ASSERT_TRUE(plain_received->skips.empty());
+  ASSERT_EQ(decoded(*plain_received), indices);
+  // truncated bytes, another version and skip pointers out of order are rejected
+  ASSERT_EQ(compc::deserialize_gap_stream(bytes.data(), bytes.size() - 1), nullptr);
+  std::vector<uint8_t> other_version = bytes;
+  other_version[3] = compc::gap_stream_version + 1;
+  ASSERT_EQ(compc::deserialize_gap_stream(other_version.data(), other_version.size()), nullptr);
+  std::vector<uint8_t> swapped = bytes;
+  std::swap_ranges(swapped.begin() + 24, swapped.begin() + 40, swapped.begin() + 40);
+  ASSERT_EQ(compc::deserialize_gap_stream(swapped.data(), swapped.size()), nullptr);
+  compc::GapStream empty{};
+  std::vector<uint8_t> empty_bytes = compc::serialize_gap_stream(empty);
+  ASSERT_EQ(empty_bytes.size(), compc::gap_stream_header_size);
+  ASSERT_EQ(compc::deserialize_gap_stream(empty_bytes.data(), empty_bytes.size())->count, 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
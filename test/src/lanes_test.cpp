@@ -0,0 +1,66 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Codec, typename T> void check_lanes(Codec& elias, const T* input, std::size_t len) {
+  for (uint32_t lanes : {4U, 8U, 16U}) {
+    std::size_t size = len;
+    std::unique_ptr<uint8_t[]> compressed = elias.compress_lanes(input, size, lanes);
+    ASSERT_NE(compressed, nullptr);
+    std::unique_ptr<T[]> output = elias.decompress_lanes(compressed.get(), size, len);
+    ASSERT_NE(output, nullptr);
+    for (std::size_t i = 0; i < len; i++) {
+      ASSERT_EQ(output[i], input[i]); // comparing values
+    }
+  }
+}
+
+TEST(Lanes_Gamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  for (std::size_t len : {1UL, 15UL, 16UL, 17UL, 100003UL}) {
+    auto random_array = compc_test::get_random_array<long>(len);
+    check_lanes(elias, random_array.get(), len);
+  }
+}
+
+TEST(Lanes_Delta, CheckValues) {
+  std::size_t len = 77777;
+  auto random_array = compc_test::get_random_array<long>(len);
+  for (std::size_t i = 0; i < len; i += 2) {
+    random_array[i] = 1 - random_array[i];
+  }
+  compc::EliasDelta<long> elias{1, true};
+  check_lanes(elias, random_array.get(), len);
+}
+
+TEST(Lanes_LongCodes, CheckValues) {
+  std::size_t len = 1000;
+  std::vector<uint64_t> input(len);
+  for (std::size_t i = 0; i < len; i++) {
+    input[i] = (uint64_t{1} << (i % 64)) + i % 3;
+  }
+  compc::EliasGamma<uint64_t> gamma;
+  check_lanes(gamma, input.data(), len);
+  compc::EliasDelta<uint64_t> delta;
+  check_lanes(delta, input.data(), len);
+}
+
+TEST(Lanes_Invalid, CheckValues) {
+  std::size_t size = 4;
+  uint32_t input[4] = {1, 2, 0, 4};
+  compc::EliasGamma<uint32_t> elias;
+  ASSERT_EQ(elias.compress_lanes(input, size, 4), nullptr);
+  input[2] = 3;
+  ASSERT_EQ(elias.compress_lanes(input, size, 5), nullptr);
+  std::unique_ptr<uint8_t[]> compressed = elias.compress_lanes(input, size, 4);
+  ASSERT_EQ(elias.decompress_lanes(compressed.get(), size - 1, 4), nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,75 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Codec> void check_segments(Codec& elias, std::size_t chunks_per_segment) {
+  std::size_t len = 100000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::SegmentedOutput output = elias.compress_segments(random_array.get(), len, chunks_per_segment);
+  ASSERT_NE(output.storage, nullptr);
+  std::size_t values = 0;
+  std::size_t bytes = 0;
+  // segments are copied to separate buffers, as a receiver would see them
+  std::vector<std::vector<uint8_t>> received;
+  for (const compc::Segment& segment : output.segments) {
+    ASSERT_EQ(reinterpret_cast<std::uintptr_t>(segment.data) % 64, 0);
+    values += segment.values;
+    bytes += segment.size;
+    received.emplace_back(segment.data, segment.data + segment.size);
+  }
+  ASSERT_EQ(values, len);
+  std::size_t contiguous = len;
+  elias.compress(random_array.get(), contiguous);
+  // byte alignment costs less than a byte per segment
+  ASSERT_LE(bytes, contiguous + output.segments.size());
+  std::vector<compc::Segment> segments = output.segments;
+  for (std::size_t s = 0; s < segments.size(); s++) {
+    segments[s].data = received[s].data();
+  }
+  std::unique_ptr<long[]> decoded = elias.decompress_segments(segments);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(decoded[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(Segments_RoundTripGamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 4;
+  check_segments(elias, 16);
+  check_segments(elias, 1);
+}
+
+TEST(Segments_RoundTripDelta, CheckValues) {
+  compc::EliasDelta<long> elias;
+  elias.num_threads = 4;
+  check_segments(elias, 3);
+}
+
+TEST(Segments_RoundTripOmega, CheckValues) {
+  compc::EliasOmega<long> elias;
+  elias.num_threads = 4;
+  check_segments(elias, 1000);
+}
+
+TEST(Segments_Transforms, CheckValues) {
+  int32_t input[10] = {0, -3, 2000, 2, -50, 1, 25345, -11, 1000000, 0};
+  compc::EliasDelta<int32_t> elias{1, true, 2, 2};
+  compc::SegmentedOutput output = elias.compress_segments(input, 10, 2);
+  ASSERT_EQ(output.segments.size(), 3);
+  std::unique_ptr<int32_t[]> decoded = elias.decompress_segments(output.segments);
+  for (std::size_t i = 0; i < 10; i++) {
+    ASSERT_EQ(decoded[i], input[i]);
+  }
+  uint32_t invalid[3] = {1, 0, 2};
+  compc::EliasGamma<uint32_t> gamma;
+  ASSERT_EQ(gamma.compress_segments(invalid, 3).storage, nullptr);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
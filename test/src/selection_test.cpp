@@ -0,0 +1,103 @@
+#include "compintc/index_stream.hpp"
+#include "compintc/selection.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <random>
+#include <vector>
+
+std::vector<float> random_gradient(std::size_t length) {
+  std::mt19937 generator(11);
+  std::normal_distribution<float> distribution(0.0F, 1.0F);
+  std::vector<float> gradient(length);
+  for (float& value : gradient) {
+    value = distribution(generator);
+  }
+  return gradient;
+}
+
+std::vector<uint64_t> decoded(const compc::GapStream& stream) {
+  std::unique_ptr<uint64_t[]> output = compc::decode_gap_stream<uint64_t>(stream);
+  return std::vector<uint64_t>(output.get(), output.get() + stream.count);
+}
+
+TEST(Selection_Threshold, CheckValues) {
+  std::vector<float> gradient = random_gradient(200000);
+  std::vector<uint64_t> expected;
+  for (std::size_t i = 0; i < gradient.size(); i++) {
+    if (std::abs(gradient[i]) >= 2.0F) {
+      expected.push_back(i);
+    }
+  }
+  for (compc::CodecId codec : {compc::CodecId::gamma, compc::CodecId::delta, compc::CodecId::omega}) {
+    compc::SparseSelection<float> selection =
+        compc::select_threshold<float>(gradient.data(), gradient.size(), 2.0F, codec, true, 4);
+    ASSERT_EQ(decoded(selection.indices), expected);
+    ASSERT_EQ(selection.values.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); i++) {
+      ASSERT_EQ(selection.values[i], gradient[expected[i]]);
+    }
+  }
+  // the same stream as encoding the selected indices separately
+  std::unique_ptr<compc::GapStream> separate = compc::encode_gap_stream<uint64_t>(expected.data(), expected.size());
+  compc::SparseSelection<float> selection = compc::select_threshold<float>(gradient.data(), gradient.size(), 2.0F);
+  ASSERT_EQ(selection.indices.data, separate->data);
+  ASSERT_TRUE(selection.values.empty());
+}
+
+TEST(Selection_TopK, CheckValues) {
+  std::vector<double> gradient(100000, 0.5);
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  for (std::size_t i = 0; i < gradient.size(); i += 3) {
+    gradient[i] = distribution(generator);
+  }
+  // many ties at the threshold, the smaller indices are selected
+  for (std::size_t k : {std::size_t{1}, std::size_t{1000}, std::size_t{40000}, std::size_t{100000}}) {
+    compc::SparseSelection<double> selection =
+        compc::select_top_k<double>(gradient.data(), gradient.size(), k, compc::CodecId::delta, true, 4);
+    std::vector<std::size_t> order(gradient.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&](std::size_t a, std::size_t b) { return std::abs(gradient[a]) > std::abs(gradient[b]); });
+    std::vector<uint64_t> expected(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k));
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(decoded(selection.indices), expected);
+    ASSERT_EQ(selection.values.size(), k);
+  }
+}
+
+TEST(Selection_TopKRadix, CheckValues) {
+  // values close together need several histogram passes, zeros are ties that stop the refinement early
+  std::vector<float> gradient(200000, 0.0F);
+  std::mt19937 generator(9);
+  std::uniform_real_distribution<float> distribution(1.0F, 1.001F);
+  for (std::size_t i = 0; i < gradient.size(); i += 2) {
+    gradient[i] = i % 4 == 0 ? distribution(generator) : -distribution(generator);
+  }
+  std::vector<std::size_t> order(gradient.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&](std::size_t a, std::size_t b) { return std::abs(gradient[a]) > std::abs(gradient[b]); });
+  for (std::size_t k : {std::size_t{7}, std::size_t{50000}, std::size_t{100000}, std::size_t{150001}}) {
+    compc::SparseSelection<float> selection =
+        compc::select_top_k<float>(gradient.data(), gradient.size(), k, compc::CodecId::gamma, false, 3);
+    std::vector<uint64_t> expected(order.begin(), order.begin() + static_cast<std::ptrdiff_t>(k));
+    std::sort(expected.begin(), expected.end());
+    ASSERT_EQ(decoded(selection.indices), expected);
+  }
+}
+
+TEST(Selection_Empty, CheckValues) {
+  std::vector<float> gradient(1000, 0.1F);
+  ASSERT_EQ(compc::select_threshold<float>(gradient.data(), gradient.size(), 1.0F).indices.count, 0);
+  ASSERT_EQ(compc::select_top_k<float>(gradient.data(), gradient.size(), 0).indices.count, 0);
+  ASSERT_EQ(compc::select_threshold<float>(nullptr, 0, 1.0F).indices.count, 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
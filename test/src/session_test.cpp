@@ -0,0 +1,108 @@
+#include "compintc/session.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+// a top-k like index set that keeps most of its indices from one round to the next
+std::vector<uint32_t> next_round(const std::vector<uint32_t>& previous, std::mt19937& generator) {
+  std::uniform_int_distribution<uint32_t> universe(0, 999999);
+  std::uniform_int_distribution<int> keep(0, 19);
+  std::vector<uint32_t> next;
+  for (uint32_t index : previous) {
+    if (keep(generator) != 0) {
+      next.push_back(index);
+    }
+  }
+  while (next.size() < 10000) {
+    for (std::size_t i = next.size(); i < 10000; i++) {
+      next.push_back(universe(generator));
+    }
+    std::sort(next.begin(), next.end());
+    next.erase(std::unique(next.begin(), next.end()), next.end());
+  }
+  return next;
+}
+} // namespace
+
+TEST(Session_Rounds, CheckValues) {
+  std::mt19937 generator(3);
+  compc::SessionEncoder encoder;
+  compc::SessionDecoder decoder;
+  std::vector<uint32_t> indices;
+  for (int round = 1; round <= 10; round++) {
+    indices = next_round(indices, generator);
+    std::unique_ptr<compc::SessionDelta> delta = encoder.encode(indices.data(), indices.size());
+    ASSERT_NE(delta, nullptr);
+    ASSERT_EQ(delta->keyframe, round == 1);
+    if (round > 1) {
+      // only about a tenth of the set changes
+      std::size_t delta_bytes = delta->insertions.data.size() + delta->deletions.data.size();
+      ASSERT_LT(delta_bytes * 3, encoder.state().data.size());
+    }
+    ASSERT_TRUE(decoder.apply(*delta));
+    ASSERT_EQ(decoder.round(), encoder.round());
+    ASSERT_EQ(decoder.size(), indices.size());
+    std::unique_ptr<uint32_t[]> decoded = decoder.indices<uint32_t>();
+    for (std::size_t i = 0; i < indices.size(); i++) {
+      ASSERT_EQ(decoded[i], indices[i]); // comparing values
+    }
+    ASSERT_EQ(decoder.state().data, encoder.state().data);
+  }
+}
+
+TEST(Session_LostDelta, CheckValues) {
+  std::mt19937 generator(5);
+  compc::SessionEncoder encoder;
+  compc::SessionDecoder decoder;
+  std::vector<uint32_t> indices = next_round({}, generator);
+  ASSERT_TRUE(decoder.apply(*encoder.encode(indices.data(), indices.size())));
+  indices = next_round(indices, generator);
+  std::unique_ptr<compc::SessionDelta> lost = encoder.encode(indices.data(), indices.size());
+  indices = next_round(indices, generator);
+  std::unique_ptr<compc::SessionDelta> delta = encoder.encode(indices.data(), indices.size());
+  // a delta that skips a round is rejected, the state stays the same
+  ASSERT_FALSE(decoder.apply(*delta));
+  ASSERT_EQ(decoder.round(), 1);
+  // applying the same delta twice is rejected too
+  ASSERT_TRUE(decoder.apply(*lost));
+  ASSERT_FALSE(decoder.apply(*lost));
+  encoder.reset();
+  indices = next_round(indices, generator);
+  std::unique_ptr<compc::SessionDelta> keyframe = encoder.encode(indices.data(), indices.size());
+  ASSERT_TRUE(keyframe->keyframe);
+  ASSERT_TRUE(decoder.apply(*keyframe));
+  ASSERT_EQ(decoder.state().data, encoder.state().data);
+}
+
+TEST(Session_InvalidInput, CheckValues) {
+  compc::SessionEncoder encoder;
+  compc::SessionDecoder decoder;
+  int64_t first[4] = {1, 5, 9, 12};
+  ASSERT_TRUE(decoder.apply(*encoder.encode(first, 4)));
+  int64_t unsorted[3] = {1, 9, 5};
+  ASSERT_EQ(encoder.encode(unsorted, 3), nullptr);
+  int64_t negative[2] = {-1, 5};
+  ASSERT_EQ(encoder.encode(negative, 2), nullptr);
+  ASSERT_EQ(encoder.round(), 1);
+
+  // deleting an index that is not in the set
+  compc::SessionDelta delta;
+  delta.round = 2;
+  int64_t missing[1] = {7};
+  delta.deletions = *compc::encode_gap_stream(missing, 1);
+  ASSERT_FALSE(decoder.apply(delta));
+  // inserting one that is
+  delta.deletions = compc::GapStream{};
+  int64_t present[1] = {9};
+  delta.insertions = *compc::encode_gap_stream(present, 1);
+  ASSERT_FALSE(decoder.apply(delta));
+  ASSERT_EQ(decoder.size(), 4);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,65 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+
+template <typename Codec> void check_single_pass(Codec& elias, std::size_t len) {
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  std::size_t two_pass_size = len;
+  std::unique_ptr<uint8_t[]> two_pass = elias.compress(random_array.get(), two_pass_size);
+  elias.single_pass = true;
+  std::size_t single_pass_size = len;
+  std::unique_ptr<uint8_t[]> single_pass = elias.compress(random_array.get(), single_pass_size);
+  elias.single_pass = false;
+  // the output does not depend on the partitioning into chunks
+  ASSERT_EQ(single_pass_size, two_pass_size);
+  ASSERT_EQ(std::memcmp(single_pass.get(), two_pass.get(), two_pass_size), 0);
+  std::unique_ptr<long[]> output = elias.decompress(single_pass.get(), single_pass_size, len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(SinglePass_Gamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 3;
+  for (std::size_t len : {1UL, 999UL, 1000UL, 1001UL, 123457UL}) {
+    check_single_pass(elias, len);
+  }
+}
+
+TEST(SinglePass_Delta, CheckValues) {
+  compc::EliasDelta<long> elias{0, false, 50, 700};
+  elias.num_threads = 4;
+  for (std::size_t len : {7UL, 2801UL, 100000UL}) {
+    check_single_pass(elias, len);
+  }
+}
+
+TEST(SinglePass_Omega, CheckValues) {
+  compc::EliasOmega<long> elias{5, true};
+  elias.num_threads = 2;
+  for (std::size_t len : {3UL, 50000UL}) {
+    check_single_pass(elias, len);
+  }
+}
+
+TEST(SinglePass_InvalidInput, CheckValues) {
+  std::size_t len = 10000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  random_array[7777] = 0;
+  compc::EliasGamma<long> elias;
+  elias.single_pass = true;
+  elias.num_threads = 2;
+  std::size_t size = len;
+  ASSERT_EQ(elias.compress(random_array.get(), size), nullptr);
+  ASSERT_EQ(size, len);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,119 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <limits>
+#include <vector>
+
+template <typename Codec, typename T> void check_small_message(Codec& elias, const T* input, std::size_t len) {
+  std::size_t small_size = len;
+  std::unique_ptr<uint8_t[]> small = elias.compress(input, small_size);
+  std::size_t threshold = elias.small_message_threshold;
+  elias.small_message_threshold = 0;
+  std::size_t parallel_size = len;
+  std::unique_ptr<uint8_t[]> parallel = elias.compress(input, parallel_size);
+  std::unique_ptr<T[]> parallel_output = elias.decompress(parallel.get(), parallel_size, len);
+  elias.small_message_threshold = threshold;
+  // both paths write the same stream
+  ASSERT_EQ(small_size, parallel_size);
+  ASSERT_EQ(std::memcmp(small.get(), parallel.get(), parallel_size), 0);
+  std::unique_ptr<T[]> output = elias.decompress(small.get(), small_size, len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], input[i]); // comparing values
+    ASSERT_EQ(parallel_output[i], input[i]);
+  }
+}
+
+TEST(SmallMessage_Gamma, CheckValues) {
+  compc::EliasGamma<long> elias;
+  elias.num_threads = 3;
+  for (std::size_t len : {1UL, 255UL, 256UL, 257UL, 4095UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    check_small_message(elias, random_array.get(), len);
+  }
+}
+
+TEST(SmallMessage_Delta, CheckValues) {
+  compc::EliasDelta<long> elias{3, true};
+  elias.num_threads = 2;
+  for (std::size_t len : {2UL, 511UL, 3000UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    random_array[len / 2] = -17;
+    check_small_message(elias, random_array.get(), len);
+  }
+}
+
+TEST(SmallMessage_Omega, CheckValues) {
+  compc::EliasOmega<long> elias{0, true};
+  elias.num_threads = 2;
+  for (std::size_t len : {7UL, 1000UL}) {
+    std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+    check_small_message(elias, random_array.get(), len);
+  }
+}
+
+TEST(SmallMessage_WideValues, CheckValues) {
+  std::vector<uint64_t> input = {1, 2, 3, (1ULL << 32U) - 1, 1ULL << 32U, (1ULL << 63U) + 12345,
+                                 std::numeric_limits<uint64_t>::max()};
+  compc::EliasGamma<uint64_t> gamma;
+  check_small_message(gamma, input.data(), input.size());
+  compc::EliasDelta<uint64_t> delta;
+  check_small_message(delta, input.data(), input.size());
+  compc::EliasOmega<uint64_t> omega;
+  check_small_message(omega, input.data(), input.size());
+  std::vector<int16_t> narrow = {-16000, 16000, -1, 1, 5, -3};
+  compc::EliasDelta<int16_t> mapped{0, true};
+  check_small_message(mapped, narrow.data(), narrow.size());
+}
+
+TEST(SmallMessage_CallerBuffer, CheckValues) {
+  std::size_t len = 300;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias{2, true};
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> expected = elias.compress(random_array.get(), size);
+  // the scratch does not have to be zeroed
+  std::vector<uint8_t> scratch(size, 0xA5);
+  ASSERT_EQ(elias.compress_small(random_array.get(), len, scratch.data(), size), size);
+  ASSERT_EQ(std::memcmp(scratch.data(), expected.get(), size), 0);
+  // one byte short
+  ASSERT_EQ(elias.compress_small(random_array.get(), len, scratch.data(), size - 1), 0);
+  std::vector<long> output(len);
+  elias.decompress_small(scratch.data(), size, output.data(), len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+}
+
+TEST(SmallMessage_InvalidInput, CheckValues) {
+  long input[5] = {4, 1, 0, 9, 2};
+  compc::EliasOmega<long> elias;
+  std::size_t size = 5;
+  ASSERT_EQ(elias.compress(input, size), nullptr);
+  ASSERT_EQ(size, 5);
+  uint8_t scratch[64];
+  ASSERT_EQ(elias.compress_small(input, 5, scratch, sizeof(scratch)), 0);
+}
+
+TEST(SmallMessage_EmptyInput, CheckValues) {
+  compc::CompressionStats stats;
+  compc::EliasGamma<long> elias;
+  elias.stats = &stats;
+  long input[1] = {1};
+  std::size_t size = 0;
+  std::unique_ptr<uint8_t[]> compressed = elias.compress(input, size);
+  ASSERT_NE(compressed, nullptr);
+  ASSERT_EQ(size, 0);
+  ASSERT_EQ(stats.bits_per_value, 0.0); // not NaN
+  std::unique_ptr<long[]> output = elias.decompress(compressed.get(), size, 0);
+  ASSERT_NE(output, nullptr);
+  ASSERT_EQ(stats.bits_per_value, 0.0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
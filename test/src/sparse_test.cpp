@@ -0,0 +1,113 @@
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "compintc/sparse.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+// random CSR matrix with empty rows, dense rows and sorted unique columns
+compc::CsrMatrix<int32_t> random_csr(std::size_t rows, std::size_t columns) {
+  std::mt19937 generator(7);
+  std::vector<int32_t> row_ptr = {0};
+  std::vector<int32_t> col_idx;
+  for (std::size_t r = 0; r < rows; r++) {
+    double density = (r % 7 == 0) ? 0.0 : (r % 11 == 0 ? 0.5 : 0.01);
+    std::bernoulli_distribution keep(density);
+    for (std::size_t c = 0; c < columns; c++) {
+      if (keep(generator)) {
+        col_idx.push_back(static_cast<int32_t>(c));
+      }
+    }
+    row_ptr.push_back(static_cast<int32_t>(col_idx.size()));
+  }
+  compc::CsrMatrix<int32_t> matrix{rows, col_idx.size(), std::make_unique<int32_t[]>(rows + 1),
+                                   std::make_unique<int32_t[]>(col_idx.size() + 1)};
+  std::copy(row_ptr.begin(), row_ptr.end(), matrix.row_ptr.get());
+  std::copy(col_idx.begin(), col_idx.end(), matrix.col_idx.get());
+  return matrix;
+}
+
+template <typename Codec> void check_csr_round_trip(Codec& elias) {
+  compc::CsrMatrix<int32_t> matrix = random_csr(3000, 2000);
+  compc::CompressedCsr compressed = compc::compress_csr<int32_t>(elias, matrix.row_ptr.get(), matrix.col_idx.get(),
+                                                                 matrix.rows);
+  ASSERT_NE(compressed.payload, nullptr);
+  ASSERT_GT(compressed.block_rows.size(), 1); // several blocks to decode in parallel
+  // gap coding needs far less than the 32 bits per index of the raw arrays
+  ASSERT_LT(compressed.payload_bytes * 8, (matrix.rows + matrix.nnz) * 16);
+  compc::CsrMatrix<int32_t> output = compc::decompress_csr<int32_t>(elias, compressed);
+  ASSERT_NE(output.row_ptr, nullptr);
+  ASSERT_EQ(output.nnz, matrix.nnz);
+  for (std::size_t r = 0; r <= matrix.rows; r++) {
+    ASSERT_EQ(output.row_ptr[r], matrix.row_ptr[r]);
+  }
+  for (std::size_t i = 0; i < matrix.nnz; i++) {
+    ASSERT_EQ(output.col_idx[i], matrix.col_idx[i]);
+  }
+}
+
+TEST(Sparse_RoundTripGamma, CheckValues) {
+  compc::EliasGamma<int32_t> elias;
+  elias.num_threads = 4;
+  check_csr_round_trip(elias);
+}
+
+TEST(Sparse_RoundTripDelta, CheckValues) {
+  compc::EliasDelta<int32_t> elias;
+  elias.num_threads = 4;
+  check_csr_round_trip(elias);
+}
+
+TEST(Sparse_RoundTripOmega, CheckValues) {
+  compc::EliasOmega<int32_t> elias;
+  elias.num_threads = 4;
+  check_csr_round_trip(elias);
+}
+
+TEST(Sparse_InvalidMatrix, CheckValues) {
+  compc::EliasGamma<uint32_t> elias;
+  uint32_t row_ptr[3] = {0, 2, 3};
+  uint32_t unsorted[3] = {5, 1, 0};
+  ASSERT_EQ(compc::compress_csr<uint32_t>(elias, row_ptr, unsorted, 2).payload, nullptr);
+  uint32_t duplicate[3] = {1, 1, 0};
+  ASSERT_EQ(compc::compress_csr<uint32_t>(elias, row_ptr, duplicate, 2).payload, nullptr);
+  uint32_t decreasing[3] = {0, 2, 1};
+  uint32_t valid[3] = {0, 1, 0};
+  ASSERT_EQ(compc::compress_csr<uint32_t>(elias, decreasing, valid, 2).payload, nullptr);
+}
+
+TEST(Sparse_CooToCsr, CheckValues) {
+  uint16_t rows[6] = {2, 0, 2, 3, 0, 2};
+  uint16_t columns[6] = {4, 7, 1, 0, 3, 9};
+  compc::CsrMatrix<uint16_t> matrix = compc::coo_to_csr<uint16_t>(rows, columns, 6, 5);
+  std::vector<uint16_t> row_ptr(matrix.row_ptr.get(), matrix.row_ptr.get() + 6);
+  std::vector<uint16_t> col_idx(matrix.col_idx.get(), matrix.col_idx.get() + 6);
+  ASSERT_EQ(row_ptr, (std::vector<uint16_t>{0, 2, 2, 5, 6, 6}));
+  ASSERT_EQ(col_idx, (std::vector<uint16_t>{3, 7, 1, 4, 9, 0}));
+
+  compc::EliasDelta<uint16_t> elias;
+  compc::CompressedCsr compressed = compc::compress_csr<uint16_t>(elias, matrix.row_ptr.get(), matrix.col_idx.get(), 5);
+  compc::CsrMatrix<uint16_t> output = compc::decompress_csr<uint16_t>(elias, compressed);
+  for (std::size_t i = 0; i < 6; i++) {
+    ASSERT_EQ(output.row_ptr[i], row_ptr[i]);
+    ASSERT_EQ(output.col_idx[i], col_idx[i]);
+  }
+}
+
+TEST(Sparse_EmptyMatrix, CheckValues) {
+  compc::EliasGamma<int64_t> elias;
+  int64_t row_ptr[4] = {0, 0, 0, 0};
+  compc::CompressedCsr compressed = compc::compress_csr<int64_t>(elias, row_ptr, nullptr, 3);
+  ASSERT_NE(compressed.payload, nullptr);
+  compc::CsrMatrix<int64_t> output = compc::decompress_csr<int64_t>(elias, compressed);
+  ASSERT_NE(output.row_ptr, nullptr);
+  ASSERT_EQ(output.nnz, 0);
+  ASSERT_EQ(output.row_ptr[3], 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
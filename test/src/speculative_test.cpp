@@ -0,0 +1,80 @@
+#include "compintc/container.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/elias_omega.hpp"
+#include "helpers.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <vector>
+
+template <typename Codec, typename T> void check_speculative(Codec& elias, const T* input, std::size_t len) {
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> compressed = elias.compress(input, size);
+  for (int threads : {2, 3, 8}) {
+    elias.num_threads = threads;
+    std::unique_ptr<T[]> output = elias.decompress_speculative(compressed.get(), size, len);
+    for (std::size_t i = 0; i < len; i++) {
+      ASSERT_EQ(output[i], input[i]); // comparing values
+    }
+  }
+}
+
+TEST(Speculative_Gamma, CheckValues) {
+  std::size_t len = 200000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  check_speculative(elias, random_array.get(), len);
+  // too short to be split, decoded serially
+  check_speculative(elias, random_array.get(), 100);
+}
+
+TEST(Speculative_Delta, CheckValues) {
+  std::size_t len = 150001;
+  auto random_array = compc_test::get_random_array<long>(len);
+  for (std::size_t i = 0; i < len; i += 3) {
+    random_array[i] = -random_array[i];
+  }
+  compc::EliasDelta<long> elias{0, true};
+  check_speculative(elias, random_array.get(), len);
+}
+
+TEST(Speculative_Omega, CheckValues) {
+  std::size_t len = 100000;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasOmega<long> elias;
+  check_speculative(elias, random_array.get(), len);
+}
+
+TEST(Speculative_LongCodes, CheckValues) {
+  // long runs of zeros and values close to the maximum, so the ranges often start inside a value
+  std::size_t len = 50000;
+  std::vector<uint64_t> input(len);
+  for (std::size_t i = 0; i < len; i++) {
+    input[i] = (i % 2 == 0) ? (uint64_t{1} << 63U) + i : uint64_t{1} << (i % 64);
+  }
+  compc::EliasGamma<uint64_t> gamma;
+  check_speculative(gamma, input.data(), len);
+  compc::EliasDelta<uint64_t> delta;
+  check_speculative(delta, input.data(), len);
+  compc::EliasOmega<uint64_t> omega;
+  check_speculative(omega, input.data(), len);
+}
+
+TEST(Speculative_LegacyFrame, CheckValues) {
+  std::size_t len = 100000;
+  std::size_t len_copy = len;
+  auto random_array = compc_test::get_random_array<long>(len);
+  compc::EliasGamma<long> elias;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed<long>(elias, random_array.get(), len, false);
+  std::size_t array_length = 0;
+  std::unique_ptr<long[]> output = compc::decompress_auto<long>(frame.get(), len, array_length, 4);
+  ASSERT_EQ(array_length, len_copy);
+  for (std::size_t i = 0; i < len_copy; i++) {
+    ASSERT_EQ(output[i], random_array[i]);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
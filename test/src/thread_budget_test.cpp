@@ -0,0 +1,196 @@
+#include "compintc/container.hpp"
+#include "compintc/decode_apply.hpp"
+#include "compintc/elias_delta.hpp"
+#include "compintc/elias_gamma.hpp"
+#include "compintc/index_set.hpp"
+#include "compintc/selection.hpp"
+#include "compintc/thread_budget.hpp"
+#include "helpers.hpp"
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <omp.h>
+#include <thread>
+#include <vector>
+
+TEST(ThreadBudget_Leases, CheckValues) {
+  compc::ThreadBudget budget(4);
+  ASSERT_EQ(budget.capacity(), 4);
+  ASSERT_EQ(compc::ThreadLease::limit(6), 6); // no lease
+  {
+    compc::ThreadLease lease(&budget, 3);
+    ASSERT_EQ(budget.available(), 1);
+    ASSERT_EQ(compc::ThreadLease::limit(6), 3);
+    ASSERT_EQ(compc::ThreadLease::limit(2), 2);
+    {
+      // nested leases take nothing
+      compc::ThreadLease nested(&budget, 3);
+      ASSERT_EQ(budget.available(), 1);
+      ASSERT_EQ(compc::ThreadLease::limit(6), 3);
+    }
+    std::thread other([&budget] {
+      compc::ThreadLease second(&budget, 3);
+      ASSERT_EQ(budget.available(), 0);
+      ASSERT_EQ(compc::ThreadLease::limit(3), 1);
+      // the budget is used up, the calling thread still runs
+      std::thread third([&budget] {
+        compc::ThreadLease lease_when_empty(&budget, 2);
+        ASSERT_EQ(compc::ThreadLease::limit(2), 1);
+        ASSERT_EQ(budget.available(), 0);
+      });
+      third.join();
+    });
+    other.join();
+    ASSERT_EQ(budget.available(), 1);
+  }
+  ASSERT_EQ(budget.available(), 4);
+  ASSERT_EQ(compc::ThreadLease::limit(6), 6);
+}
+
+TEST(ThreadBudget_NoNesting, CheckValues) {
+  int limit_inside = 0;
+#pragma omp parallel num_threads(2) default(none) shared(limit_inside)
+  {
+#pragma omp single
+    limit_inside = omp_in_parallel() != 0 ? compc::ThreadLease::limit(8) : 1;
+  }
+  ASSERT_EQ(limit_inside, 1);
+}
+
+TEST(ThreadBudget_ConstructorKeepsOpenMPDefault, CheckValues) {
+  int before = omp_get_max_threads();
+  omp_set_num_threads(5);
+  compc::EliasGamma<long> gamma;
+  compc::EliasDelta<long> delta(1, true);
+  compc::EliasGamma<long> copy(gamma);
+  ASSERT_EQ(omp_get_max_threads(), 5);
+  omp_set_num_threads(before);
+}
+
+TEST(ThreadBudget_ConcurrentCallers, CheckValues) {
+  const std::size_t len = 100000;
+  const int callers = 4;
+  compc::ThreadBudget budget(3);
+  std::vector<std::unique_ptr<long[]>> inputs;
+  for (int c = 0; c < callers; c++) {
+    inputs.push_back(compc_test::get_random_array<long>(len));
+  }
+  // one codec used by every caller, and one per caller that records its stats
+  compc::EliasDelta<long> shared_codec{1, true};
+  shared_codec.num_threads = 3;
+  shared_codec.thread_budget = &budget;
+  std::vector<compc::CompressionStats> stats(callers);
+  std::vector<int> correct(callers, 0);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < callers; c++) {
+    threads.emplace_back([&, c] {
+      auto caller = static_cast<std::size_t>(c);
+      compc::EliasGamma<long> own{1, true};
+      own.num_threads = 3;
+      own.thread_budget = &budget;
+      own.stats = &stats[caller];
+      bool same = true;
+      for (int round = 0; round < 5; round++) {
+        std::size_t size = len;
+        std::unique_ptr<uint8_t[]> comp = own.compress(inputs[caller].get(), size);
+        same = same && own.stats->threads_used <= 3;
+        std::unique_ptr<long[]> output = own.decompress(comp.get(), size, len);
+        std::size_t shared_size = len;
+        std::unique_ptr<uint8_t[]> shared_comp = shared_codec.compress(inputs[caller].get(), shared_size);
+        std::unique_ptr<long[]> shared_output = shared_codec.decompress(shared_comp.get(), shared_size, len);
+        for (std::size_t i = 0; i < len; i++) {
+          same = same && output[i] == inputs[caller][i] && shared_output[i] == inputs[caller][i];
+        }
+      }
+      correct[caller] = same ? 1 : 0;
+    });
+  }
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+  for (int c = 0; c < callers; c++) {
+    ASSERT_EQ(correct[static_cast<std::size_t>(c)], 1);
+  }
+  ASSERT_EQ(budget.available(), 3);
+}
+
+// records the most threads that are free in the budget while chunks are encoded
+struct WatchedDelta : compc::EliasDelta<long> {
+  WatchedDelta() : compc::EliasDelta<long>(1, true) {}
+  void encode_chunk(const long* array, std::size_t start_index, std::size_t end_index, std::size_t start_bit,
+                    std::size_t end_bit, uint8_t* compressed) override {
+    int available = thread_budget->available();
+    int seen = most_available.load();
+    while (available > seen && !most_available.compare_exchange_weak(seen, available)) {
+    }
+    compc::EliasDelta<long>::encode_chunk(array, start_index, end_index, start_bit, end_bit, compressed);
+  }
+  std::atomic<int> most_available{0};
+};
+
+TEST(ThreadBudget_Framed, CheckValues) {
+  const std::size_t len = 200000;
+  std::unique_ptr<long[]> random_array = compc_test::get_random_array<long>(len);
+  compc::ThreadBudget budget(2);
+  compc::CompressionStats stats;
+  WatchedDelta elias;
+  elias.num_threads = 4;
+  elias.thread_budget = &budget;
+  elias.stats = &stats;
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed(elias, random_array.get(), size, true, true);
+  ASSERT_NE(frame, nullptr);
+  // the encode runs inside the lease of the call, with no more threads than the budget holds
+  ASSERT_EQ(elias.most_available.load(), 0);
+  ASSERT_GE(stats.chunks_per_thread.size(), 1);
+  ASSERT_LE(stats.chunks_per_thread.size(), 2);
+  ASSERT_EQ(budget.available(), 2);
+  std::size_t array_length = 0;
+  std::unique_ptr<long[]> output = compc::decompress_auto<long>(frame.get(), size, array_length, 4, nullptr, &budget);
+  ASSERT_EQ(array_length, len);
+  for (std::size_t i = 0; i < len; i++) {
+    ASSERT_EQ(output[i], random_array[i]); // comparing values
+  }
+  ASSERT_EQ(budget.available(), 2);
+}
+
+TEST(ThreadBudget_FreeFunctions, CheckValues) {
+  const std::size_t len = 50000;
+  compc::ThreadBudget budget(3);
+  std::vector<uint32_t> indices(len);
+  for (std::size_t i = 0; i < len; i++) {
+    indices[i] = static_cast<uint32_t>(3 * i + i % 2 + 1);
+  }
+  compc::EliasGamma<uint32_t> elias;
+  elias.num_threads = 2;
+  std::size_t size = len;
+  std::unique_ptr<uint8_t[]> frame = compc::compress_framed(elias, indices.data(), size, true, true);
+  // the sink runs while the call holds its lease
+  std::atomic<int> most_available{0};
+  ASSERT_TRUE(compc::decode_apply<uint32_t>(
+      frame.get(), size,
+      [&](std::size_t, uint32_t) {
+        int available = budget.available();
+        int seen = most_available.load();
+        while (available > seen && !most_available.compare_exchange_weak(seen, available)) {
+        }
+      },
+      2, &budget));
+  ASSERT_EQ(most_available.load(), 1);
+  ASSERT_TRUE(compc::verify_frame(frame.get(), size, nullptr, 2, &budget));
+  std::size_t array_length = 0;
+  ASSERT_NE(compc::decompress_auto<uint32_t>(frame.get(), size, array_length, 2, nullptr, &budget), nullptr);
+  compc::CompressedIndexSet set = compc::compress_index_set(indices.data(), len, compc::CodecId::delta, 2, &budget);
+  std::unique_ptr<uint32_t[]> decoded = compc::decompress_index_set<uint32_t>(set, 2, &budget);
+  ASSERT_EQ(decoded[len - 1], indices[len - 1]);
+  std::vector<float> gradient(len, 0.5F);
+  gradient[7] = 2.0F;
+  ASSERT_EQ(compc::select_top_k(gradient.data(), len, 10, compc::CodecId::gamma, false, 2, &budget).indices.count, 10);
+  // every call returned its threads
+  ASSERT_EQ(budget.available(), 3);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}